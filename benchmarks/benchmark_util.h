@@ -0,0 +1,19 @@
+#pragma once
+
+#include <vector>
+#include "chess/board.h"
+#include "chess/movegen.h"
+
+// Appends the positions of the tree depth plies deep below board, in search
+// order: every node, or only the leaves when leaves_only is set
+inline void collect(Board& board, int depth, std::vector<Board>& out, bool leaves_only = false) {
+    if (!leaves_only || depth == 0) out.push_back(board);
+    if (depth == 0) return;
+    chess::MoveList moveList;
+    MoveGen::init(board, moveList, MoveGen::ALL, true);
+    for (const auto& move : moveList) {
+        board.make_move(move);
+        collect(board, depth - 1, out, leaves_only);
+        board.unmake_move(move);
+    }
+}
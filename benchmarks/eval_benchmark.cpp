@@ -0,0 +1,60 @@
+// Classic evaluation throughput: evaluates every position of small trees from a
+// set of test positions and reports evaluations per second, with and without a
+// pawn hash table (a search always has one), then the cost of each term.
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "chess/board.h"
+#include "chess/zobrist.h"
+#include "engine/evaluate.h"
+#include "engine/search.h"
+#include "benchmark_util.h"
+
+static const char* FENS[] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+};
+
+static const int TREE_DEPTH = 3;
+static const int RUNS = 10;
+
+static void run(const char* label, const std::vector<Board>& positions, PawnTable* pawns) {
+    int64_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int run = 0; run < RUNS; ++run) {
+        for (const Board& board : positions) checksum += Search::evaluate(board, pawns);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << label << (uint64_t)(positions.size() * RUNS / seconds) << " evals/s (checksum " << checksum << ")\n";
+}
+
+int main() {
+    chess::init();
+    Zobrist::init_zobrist_keys();
+
+    std::vector<Board> positions;
+    for (const char* fen : FENS) {
+        Board board;
+        std::string f = fen;
+        board.set_fen(f);
+        collect(board, TREE_DEPTH, positions);
+    }
+    std::cout << "positions: " << positions.size() << " x " << RUNS << " runs\n";
+
+    PawnTable pawns;
+    run("no pawn table: ", positions, nullptr);
+    run("pawn table:    ", positions, &pawns);
+
+    std::cout << "\n" << std::setw(14) << "term" << std::setw(12) << "ns/pos" << std::setw(14) << "cycles/pos" << "\n";
+    for (const eval::TermCost& cost : eval::profile_terms(positions, RUNS)) {
+        std::cout << std::setw(14) << cost.name << std::fixed << std::setprecision(1)
+                  << std::setw(12) << cost.ns << std::setw(14) << cost.cycles << "\n";
+    }
+    return 0;
+}
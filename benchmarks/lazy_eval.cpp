@@ -0,0 +1,85 @@
+// Lazy evaluation in qsearch: runs a fixed-depth bench with the lazy stand pat
+// off and on, and reports the time, how often the lazy path settled a stand
+// pat, and every position whose best move or score changed.
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "chess/board.h"
+#include "chess/zobrist.h"
+#include "engine/search.h"
+
+static const char* FENS[] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "2r3k1/pp3ppp/4p3/3pP3/3P4/P4N2/1P3PPP/2R3K1 w - - 0 1",
+    "6k1/5ppp/8/8/8/8/5PPP/3Q2K1 w - - 0 1",
+};
+
+static const int DEPTH = 7;
+static const int MAX_TIME_MS = 10 * 60 * 1000;   // the depth limit ends the search
+
+struct BenchResult {
+    std::vector<std::string> moves;
+    std::vector<int64_t> scores;
+    double seconds = 0;
+    uint64_t nodes = 0, qsearch_evals = 0, lazy_evals = 0;
+};
+
+static BenchResult run_bench(int margin) {
+    BenchResult result;
+    Search search(64);
+    search.lazy_eval_margin = margin;
+    search.quiet = true;
+    for (const char* fen : FENS) {
+        Board board;
+        std::string f = fen;
+        board.set_fen(f);
+        search.TT.clear();
+
+        auto start = std::chrono::steady_clock::now();
+        chess::Move best = search.start_search(board, DEPTH, MAX_TIME_MS, 0, 0, 0, 0);
+        result.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        result.moves.push_back(util::move_to_string(best));
+        result.scores.push_back(search.best_score);
+        result.nodes += search.nodes_searched;
+        result.qsearch_evals += search.qsearch_evals();
+        result.lazy_evals += search.lazy_evals();
+    }
+    return result;
+}
+
+int main() {
+    chess::init();
+    Zobrist::init_zobrist_keys();
+
+    std::cout << "depth " << DEPTH << ", " << sizeof(FENS) / sizeof(FENS[0]) << " positions\n";
+    std::cout << std::setw(8) << "margin" << std::setw(10) << "time s" << std::setw(12) << "nodes"
+              << std::setw(14) << "qsearch evals" << std::setw(10) << "lazy %" << std::setw(10) << "changed" << "\n";
+
+    const BenchResult reference = run_bench(0);
+    int total_changed = 0;
+    for (int margin : {0, 1000, 700, LAZY_EVAL_MARGIN, 300}) {
+        const BenchResult r = (margin == 0) ? reference : run_bench(margin);
+        int changed = 0;
+        for (size_t i = 0; i < r.moves.size(); ++i) {
+            if (r.moves[i] == reference.moves[i] && r.scores[i] == reference.scores[i]) continue;
+            ++changed;
+            std::cout << "  margin " << margin << ": " << FENS[i] << "\n    " << reference.moves[i] << " (cp " << reference.scores[i]
+                      << ") -> " << r.moves[i] << " (cp " << r.scores[i] << ")\n";
+        }
+        if (margin == LAZY_EVAL_MARGIN) total_changed = changed;
+
+        std::cout << std::setw(8) << margin << std::setw(10) << std::fixed << std::setprecision(2) << r.seconds
+                  << std::setw(12) << r.nodes << std::setw(14) << r.qsearch_evals
+                  << std::setw(9) << std::setprecision(1) << 100.0 * r.lazy_evals / std::max<uint64_t>(1, r.qsearch_evals) << "%"
+                  << std::setw(10) << changed << "\n";
+    }
+    std::cout << "default margin " << LAZY_EVAL_MARGIN << ": " << total_changed << " result(s) differ from the full evaluation\n";
+    return 0;
+}
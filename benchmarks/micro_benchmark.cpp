@@ -0,0 +1,226 @@
+// Micro-benchmarks of the search's hot primitives, each timed in isolation over
+// the same recorded positions and moves:
+//
+//   micro_benchmark [--positions file.epd] [--samples N] [--hash MB] [--filter name]
+//
+// The positions are recorded by a fixed-seed random playout of 24 plies from
+// each bench position (or read from an EPD/FEN file), then every legal move of
+// each, the captures among them and the keys of the positions they lead to.
+// Each primitive runs over the whole recording a few times to warm up, then in
+// samples of as many passes as fill 10 ms. It reports ns/op and TSC cycles/op:
+// the median, the fastest sample and the spread (relative standard deviation).
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "chess/board.h"
+#include "chess/movegen.h"
+#include "chess/zobrist.h"
+#include "engine/bench.h"
+#include "engine/move_picker.h"
+#include "engine/pawn_table.h"
+#include "engine/search.h"
+#include "engine/transposition.h"
+#include "engine/tuner.h"
+#include "utils/cycles.h"
+
+static const int PLAYOUT_PLIES = 24;
+static const int WARMUP_PASSES = 3;
+static const double SAMPLE_NS = 10e6; // passes are repeated until a sample takes about this long
+
+struct Recording {
+    std::vector<Board> boards;
+    std::vector<chess::MoveList> moves;    // legal moves of each board
+    std::vector<chess::MoveList> captures; // the captures among them
+    std::vector<uint64_t> keys;            // every board and every position a move leads to
+    size_t move_count = 0, capture_count = 0;
+};
+
+static void record(Recording& rec, Board& board) {
+    chess::MoveList moves, captures;
+    MoveGen::init(board, moves, MoveGen::ALL, true);
+    rec.keys.push_back(board.zobrist_key);
+    for (const auto& move : moves) {
+        if (move.flags() & chess::FLAG_CAPTURE) captures.push_back(move);
+        board.make_move(move);
+        rec.keys.push_back(board.zobrist_key);
+        board.unmake_move(move);
+    }
+    rec.boards.push_back(board);
+    rec.moves.push_back(moves);
+    rec.captures.push_back(captures);
+    rec.move_count += moves.size();
+    rec.capture_count += captures.size();
+}
+
+struct Stats {
+    double median_ns, min_ns, rsd, median_cycles;
+};
+
+// Times samples of pass, each doing ops operations. pass returns a value that
+// depends on every operation, so none of them can be optimised away.
+static Stats measure(size_t ops, int samples, const std::function<uint64_t()>& pass) {
+    static volatile uint64_t sink;
+    const auto warmup = std::chrono::steady_clock::now();
+    for (int i = 0; i < WARMUP_PASSES; ++i) sink = sink + pass();
+    const double pass_ns =
+        std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - warmup).count() / WARMUP_PASSES;
+    const int passes = std::max(1, int(SAMPLE_NS / std::max(pass_ns, 1.0)));
+
+    std::vector<double> ns(samples), cycles(samples);
+    for (int i = 0; i < samples; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        const uint64_t start_tsc = read_tsc();
+        for (int p = 0; p < passes; ++p) sink = sink + pass();
+        cycles[i] = double(read_tsc() - start_tsc) / (ops * passes);
+        ns[i] = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+                (ops * passes);
+    }
+
+    double mean = 0, variance = 0;
+    for (double x : ns) mean += x / samples;
+    for (double x : ns) variance += (x - mean) * (x - mean) / samples;
+    std::sort(ns.begin(), ns.end());
+    std::sort(cycles.begin(), cycles.end());
+    return {ns[samples / 2], ns[0], std::sqrt(variance) / mean, cycles[samples / 2]};
+}
+
+int main(int argc, char* argv[]) {
+    chess::init();
+    Zobrist::init_zobrist_keys();
+
+    std::string positions_path, filter;
+    int samples = 25;
+    size_t hash_mb = 64;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--positions" && has_value) positions_path = argv[++i];
+        else if (arg == "--samples" && has_value) samples = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--hash" && has_value) hash_mb = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--filter" && has_value) filter = argv[++i];
+        else {
+            std::cerr << "usage: micro_benchmark [--positions file.epd] [--samples N] [--hash MB] [--filter name]"
+                      << std::endl;
+            return 1;
+        }
+    }
+
+    Recording rec;
+    if (!positions_path.empty()) {
+        std::ifstream in(positions_path);
+        if (!in) {
+            std::cerr << "cannot open " << positions_path << std::endl;
+            return 1;
+        }
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.empty() || line[0] == '#') continue;
+            Board board;
+            std::string fen = tuner::fen_of_line(line);
+            board.set_fen(fen);
+            record(rec, board);
+        }
+    } else {
+        std::mt19937_64 rng(20240601);
+        for (const std::string& start : bench::POSITIONS) {
+            Board board;
+            std::string fen = start;
+            board.set_fen(fen);
+            for (int ply = 0; ply < PLAYOUT_PLIES; ++ply) {
+                record(rec, board);
+                const chess::MoveList& moves = rec.moves.back();
+                if (moves.empty()) break;
+                board.make_move(moves[rng() % moves.size()]);
+            }
+        }
+    }
+    if (rec.boards.empty()) {
+        std::cerr << "no positions" << std::endl;
+        return 1;
+    }
+
+    std::cout << rec.boards.size() << " positions, " << rec.move_count << " moves, " << rec.capture_count
+              << " captures, " << rec.keys.size() << " keys; " << samples << " samples of "
+              << SAMPLE_NS / 1e6 << " ms\n"
+              << std::setw(22) << "primitive" << std::setw(10) << "ops" << std::setw(11) << "ns/op" << std::setw(11)
+              << "min ns/op" << std::setw(8) << "rsd" << std::setw(12) << "cycles/op" << "\n";
+
+    auto run = [&](const std::string& name, size_t ops, const std::function<uint64_t()>& pass) {
+        if (!filter.empty() && name.find(filter) == std::string::npos) return;
+        const Stats s = measure(ops, samples, pass);
+        std::cout << std::setw(22) << name << std::setw(10) << ops << std::fixed << std::setprecision(2)
+                  << std::setw(11) << s.median_ns << std::setw(11) << s.min_ns << std::setprecision(1)
+                  << std::setw(7) << s.rsd * 100 << "%" << std::setw(12) << s.median_cycles << "\n";
+    };
+
+    run("MoveGen::init ALL", rec.boards.size(), [&] {
+        uint64_t sum = 0;
+        for (Board& b : rec.boards) {
+            chess::MoveList moves;
+            MoveGen::init(b, moves, MoveGen::ALL, true);
+            sum += moves.size();
+        }
+        return sum;
+    });
+    run("MoveGen::init CAPTURES", rec.boards.size(), [&] {
+        uint64_t sum = 0;
+        for (Board& b : rec.boards) {
+            chess::MoveList moves;
+            MoveGen::init(b, moves, MoveGen::CAPTURES, true);
+            sum += moves.size();
+        }
+        return sum;
+    });
+    run("make+unmake_move", rec.move_count, [&] {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < rec.boards.size(); ++i) {
+            Board& b = rec.boards[i];
+            for (const auto& move : rec.moves[i]) {
+                b.make_move(move);
+                sum += b.zobrist_key;
+                b.unmake_move(move);
+            }
+        }
+        return sum;
+    });
+    run("MovePicker::see", rec.capture_count, [&] {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < rec.boards.size(); ++i) {
+            for (const auto& move : rec.captures[i]) sum += MovePicker::see(rec.boards[i], move);
+        }
+        return sum;
+    });
+    run("Search::evaluate", rec.boards.size(), [&] {
+        uint64_t sum = 0;
+        for (const Board& b : rec.boards) sum += Search::evaluate(b);
+        return sum;
+    });
+    PawnTable pawns;
+    run("Search::evaluate pawns", rec.boards.size(), [&] {
+        uint64_t sum = 0;
+        for (const Board& b : rec.boards) sum += Search::evaluate(b, &pawns);
+        return sum;
+    });
+
+    TranspositionTable tt(hash_mb);
+    run("TT store", rec.keys.size(), [&] {
+        for (size_t i = 0; i < rec.keys.size(); ++i) {
+            tt.store({rec.keys[i], uint8_t(1 + i % 16), int64_t(i % 512), TTEntry::EXACT, chess::Move{}});
+        }
+        return uint64_t(0);
+    });
+    run("TT probe", rec.keys.size(), [&] {
+        uint64_t sum = 0;
+        TTEntry entry;
+        for (uint64_t key : rec.keys) sum += tt.probe(key, entry) ? entry.depth : 0;
+        return sum;
+    });
+    return 0;
+}
@@ -0,0 +1,74 @@
+// Pawn hash table: evaluation time with and without the table over the leaves
+// of small trees (visited in search order, so siblings share pawn structures),
+// and the hit rate seen by a fixed-depth search.
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "chess/board.h"
+#include "chess/zobrist.h"
+#include "engine/search.h"
+#include "benchmark_util.h"
+
+static const char* FENS[] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+};
+
+static const int TREE_DEPTH = 3;
+static const int SEARCH_DEPTH = 7;
+static const int RUNS = 5;
+
+static double time_evals(const std::vector<Board>& positions, PawnTable* pawns, int64_t& checksum) {
+    auto start = std::chrono::steady_clock::now();
+    for (int run = 0; run < RUNS; ++run) {
+        for (const Board& board : positions) checksum += Search::evaluate(board, pawns);
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+    chess::init();
+    Zobrist::init_zobrist_keys();
+
+    std::vector<Board> positions;
+    for (const char* fen : FENS) {
+        Board board;
+        std::string f = fen;
+        board.set_fen(f);
+        collect(board, TREE_DEPTH, positions, true);
+    }
+
+    int64_t checksum_plain = 0, checksum_hashed = 0;
+    PawnTable pawns;
+    double plain = time_evals(positions, nullptr, checksum_plain);
+    double hashed = time_evals(positions, &pawns, checksum_hashed);
+
+    std::cout << "evaluations: " << positions.size() << " x " << RUNS << " runs\n";
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "no pawn table: " << plain << " s\n";
+    std::cout << "pawn table:    " << hashed << " s (" << std::setprecision(1) << 100.0 * (plain - hashed) / plain << "% saved)\n";
+    std::cout << "hit rate:      " << 100.0 * pawns.hits / pawns.probes << "%\n";
+    if (checksum_plain != checksum_hashed) std::cout << "MISMATCH: evaluations differ with the pawn table\n";
+
+    // Hit rate inside a real search
+    Search search(64);
+    search.quiet = true;
+    uint64_t probes = 0, hits = 0;
+    for (const char* fen : FENS) {
+        Board board;
+        std::string f = fen;
+        board.set_fen(f);
+        search.TT.clear();
+
+        search.start_search(board, SEARCH_DEPTH, 10 * 60 * 1000, 0, 0, 0, 0);
+
+        probes += search.pawn_probes();
+        hits += search.pawn_hits();
+    }
+    std::cout << "search depth " << SEARCH_DEPTH << " hit rate: " << 100.0 * hits / std::max<uint64_t>(1, probes) << "%\n";
+    return checksum_plain == checksum_hashed ? 0 : 1;
+}
@@ -1,2 +1,164 @@
-// Perft benchmark tool
-int main() { return 0; }
+// Perft benchmark: move generation throughput over a suite of positions with
+// known counts (data/perft/standard.epd by default), bulk-counting the last ply.
+//
+//   perft [suite.epd] [--depth N] [--threads N] [--hash MB] [--json out.json|-]
+//   perft --divide N [--fen "<fen>"]
+//
+// Each position runs at its deepest listed depth (at most N) and is checked
+// against the suite; the exit code is 1 on any mismatch. --json writes the
+// per-position and total counts, times and nodes/s for tracking across
+// commits. --threads and --hash count with perft::count_parallel and a shared
+// perft hash of that size, cleared before every position. --divide prints the count below each root move instead, in the
+// "move: nodes" form other engines print, to find where two generators differ.
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "chess/board.h"
+#include "chess/perft.h"
+#include "chess/zobrist.h"
+
+static const char* DEFAULT_SUITES[] = {"data/perft/standard.epd", "../data/perft/standard.epd"};
+static const char* STARTPOS = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+struct Result {
+    std::string fen;
+    int depth;
+    uint64_t nodes, expected;
+    double seconds;
+};
+
+static std::string move_name(const chess::Move& move) {
+    std::string name = util::move_to_string(move);
+    if (move.flags() & chess::FLAG_PROMO) name += "  nbrq"[chess::type_of((chess::Piece)move.promo())];
+    return name;
+}
+
+static int divide(const std::string& fen, int depth) {
+    Board board;
+    std::string f = fen;
+    board.set_fen(f);
+    uint64_t total = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const perft::Division& d : perft::divide(board, depth)) {
+        std::cout << move_name(d.move) << ": " << d.nodes << "\n";
+        total += d.nodes;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "\nNodes searched: " << total << " (" << std::fixed << std::setprecision(3) << seconds << " s)\n";
+    return 0;
+}
+
+static void write_json(std::ostream& out, const std::string& suite, size_t threads, size_t hash_mb,
+                       const std::vector<Result>& results) {
+    uint64_t nodes = 0;
+    double seconds = 0;
+    int failures = 0;
+    out << "{\n  \"suite\": \"" << suite << "\",\n  \"bulk_counting\": true,\n  \"threads\": " << threads
+        << ",\n  \"hash_mb\": " << hash_mb << ",\n  \"positions\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        nodes += r.nodes;
+        seconds += r.seconds;
+        failures += r.nodes != r.expected;
+        out << "    {\"fen\": \"" << r.fen << "\", \"depth\": " << r.depth << ", \"nodes\": " << r.nodes
+            << ", \"expected\": " << r.expected << ", \"ok\": " << (r.nodes == r.expected ? "true" : "false")
+            << ", \"seconds\": " << r.seconds << ", \"nps\": " << uint64_t(r.nodes / r.seconds) << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ],\n  \"total\": {\"nodes\": " << nodes << ", \"seconds\": " << seconds
+        << ", \"nps\": " << uint64_t(nodes / seconds) << ", \"failures\": " << failures << "}\n}\n";
+}
+
+int main(int argc, char* argv[]) {
+    chess::init();
+    Zobrist::init_zobrist_keys();
+
+    std::string suite_path, json_path, fen = STARTPOS;
+    int max_depth = 64, divide_depth = 0;
+    size_t threads = 1, hash_mb = 0;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--depth" && has_value) max_depth = std::stoi(argv[++i]);
+        else if (arg == "--threads" && has_value) threads = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--hash" && has_value) hash_mb = std::max(0, std::stoi(argv[++i]));
+        else if (arg == "--json" && has_value) json_path = argv[++i];
+        else if (arg == "--divide" && has_value) divide_depth = std::stoi(argv[++i]);
+        else if (arg == "--fen" && has_value) fen = argv[++i];
+        else if (arg[0] != '-' && suite_path.empty()) suite_path = arg;
+        else {
+            std::cerr << "usage: perft [suite.epd] [--depth N] [--threads N] [--hash MB] [--json file|-]\n"
+                         "       perft --divide N [--fen \"<fen>\"]" << std::endl;
+            return 1;
+        }
+    }
+    if (divide_depth > 0) return divide(fen, divide_depth);
+
+    if (suite_path.empty()) {
+        for (const char* path : DEFAULT_SUITES) {
+            if (std::ifstream(path)) {
+                suite_path = path;
+                break;
+            }
+        }
+    }
+    std::vector<perft::SuiteEntry> suite;
+    std::string error;
+    if (!perft::load_suite(suite_path.empty() ? DEFAULT_SUITES[0] : suite_path, suite, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+
+    std::unique_ptr<perft::Hash> hash;
+    if (hash_mb > 0) hash = std::make_unique<perft::Hash>(hash_mb);
+    std::vector<Result> results;
+    uint64_t total_nodes = 0;
+    double total_seconds = 0;
+    int failures = 0;
+    if (threads > 1 || hash) std::cout << threads << " threads, " << hash_mb << " MB hash\n";
+    std::cout << std::setw(5) << "line" << std::setw(7) << "depth" << std::setw(13) << "nodes"
+              << std::setw(10) << "time s" << std::setw(10) << "Mnps" << "  fen\n";
+    for (const perft::SuiteEntry& entry : suite) {
+        const int depth = std::min(max_depth, entry.max_depth());
+        if (depth < 1 || entry.expected[depth - 1] == 0) continue;
+        Board board;
+        std::string f = entry.fen;
+        board.set_fen(f);
+
+        if (hash) hash->clear();
+        auto start = std::chrono::steady_clock::now();
+        const uint64_t nodes = threads > 1 || hash ? perft::count_parallel(board, depth, threads, hash.get())
+                                                   : perft::count(board, depth);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        results.push_back({entry.fen, depth, nodes, entry.expected[depth - 1], seconds});
+        total_nodes += nodes;
+        total_seconds += seconds;
+
+        const bool ok = nodes == entry.expected[depth - 1];
+        failures += !ok;
+        std::cout << std::setw(5) << entry.line << std::setw(7) << depth << std::setw(13) << nodes << std::fixed
+                  << std::setprecision(3) << std::setw(10) << seconds << std::setprecision(1) << std::setw(10)
+                  << nodes / seconds / 1e6 << "  " << entry.fen << (ok ? "" : "  MISMATCH, expected ")
+                  << (ok ? "" : std::to_string(entry.expected[depth - 1])) << "\n";
+    }
+    std::cout << "\n" << results.size() << " positions, " << total_nodes << " nodes in " << std::setprecision(3)
+              << total_seconds << " s: " << std::setprecision(1) << total_nodes / total_seconds / 1e6 << " Mnps, "
+              << failures << " mismatches\n";
+
+    if (json_path == "-") {
+        write_json(std::cout, suite_path, threads, hash_mb, results);
+    } else if (!json_path.empty()) {
+        std::ofstream out(json_path);
+        write_json(out, suite_path, threads, hash_mb, results);
+        if (!out) {
+            std::cerr << "cannot write " << json_path << std::endl;
+            return 1;
+        }
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,74 @@
+// Parallel perft scaling: counts a few positions with perft::count_parallel at
+// 1/2/4/.../64 threads and 0/16/64/256 MB of shared perft hash, reporting the
+// wall time, nodes/s and the speedup over one thread without a hash. The hash
+// is cleared before every position, so only transpositions within one count
+// are reused. Every count is checked; the exit code is 1 on any mismatch.
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include "chess/board.h"
+#include "chess/perft.h"
+#include "chess/zobrist.h"
+
+struct Position {
+    const char* fen;
+    int depth;
+    uint64_t expected;
+};
+
+static const Position POSITIONS[] = {
+    {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 6, 119060324},
+    {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 5, 193690690},
+    {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 7, 178633661},
+    {"r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 5, 164075551},
+};
+
+int main() {
+    chess::init();
+    Zobrist::init_zobrist_keys();
+
+    std::cout << std::thread::hardware_concurrency() << " hardware threads\n";
+    std::cout << std::setw(8) << "hash MB" << std::setw(9) << "threads" << std::setw(10) << "tasks" << std::setw(11)
+              << "time s" << std::setw(10) << "Mnps" << std::setw(12) << "speedup" << "\n";
+
+    double baseline = 0;
+    int failures = 0;
+    for (size_t hash_mb : {0, 16, 64, 256}) {
+        std::unique_ptr<perft::Hash> hash;
+        if (hash_mb > 0) hash = std::make_unique<perft::Hash>(hash_mb);
+
+        for (size_t threads : {1, 2, 4, 8, 16, 32, 64}) {
+            double seconds = 0;
+            uint64_t nodes = 0;
+            size_t tasks = 0;
+            for (const Position& position : POSITIONS) {
+                Board board;
+                std::string fen = position.fen;
+                board.set_fen(fen);
+                if (hash) hash->clear();
+
+                perft::ParallelStats stats;
+                auto start = std::chrono::steady_clock::now();
+                const uint64_t count = perft::count_parallel(board, position.depth, threads, hash.get(), &stats);
+                seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                if (count != position.expected) {
+                    std::cerr << position.fen << " depth " << position.depth << ": " << count << ", expected "
+                              << position.expected << std::endl;
+                    ++failures;
+                }
+                nodes += count;
+                tasks += stats.tasks;
+            }
+            if (hash_mb == 0 && threads == 1) baseline = seconds;
+
+            std::cout << std::setw(8) << hash_mb << std::setw(9) << threads << std::setw(10) << tasks
+                      << std::setw(11) << std::fixed << std::setprecision(2) << seconds << std::setw(10)
+                      << std::setprecision(1) << nodes / seconds / 1e6 << std::setw(11) << std::setprecision(2)
+                      << baseline / seconds << "x\n";
+        }
+    }
+    return failures ? 1 : 0;
+}
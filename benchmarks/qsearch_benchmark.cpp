@@ -0,0 +1,55 @@
+// Quiescence search throughput: runs qsearch with a full window on every position
+// two plies deep from a set of test positions and reports nodes per second.
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "chess/board.h"
+#include "chess/zobrist.h"
+#include "engine/search.h"
+#include "benchmark_util.h"
+
+static const char* ROOT_FENS[] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+};
+
+int main() {
+    chess::init();
+    Zobrist::init_zobrist_keys();
+
+    std::vector<Board> positions;
+    for (const char* fen : ROOT_FENS) {
+        Board board;
+        std::string f = fen;
+        board.set_fen(f);
+        collect(board, 2, positions, true);
+    }
+
+    Search search(16);
+    const int runs = 3;
+    uint64_t total_nodes = 0;
+    // One worker for all positions, as in a search: its pawn table stays warm
+    auto worker = std::make_unique<SearchWorker>();
+    auto start = std::chrono::steady_clock::now();
+    for (int run = 0; run < runs; ++run) {
+        search.TT.clear();
+        for (Board& board : positions) {
+            worker->reset(board);
+            search.search_captures_only(*worker, 0, NEG_INFINITY_EVAL, -NEG_INFINITY_EVAL, true);
+            total_nodes += worker->nodes.load();
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "positions: " << positions.size() << " x " << runs << " runs\n";
+    std::cout << "qsearch nodes: " << total_nodes << "\n";
+    std::cout << "time: " << seconds << " s\n";
+    std::cout << "nps: " << (uint64_t)(total_nodes / seconds) << std::endl;
+    return 0;
+}
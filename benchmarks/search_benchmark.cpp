@@ -1,2 +1,89 @@
-// Search performance tests
-int main() { return 0; }
+// Search performance tests: the UCI "bench" as a benchmark target.
+//
+//   search_benchmark [depth] [--signature nodes] [--perf] [--json out.json|-]
+//
+// Searches the built-in bench positions to a fixed depth (bench::DEFAULT_DEPTH
+// by default) on one thread and prints the nodes and time per position, then
+// the total nodes, time and nodes/s. The total node count is the signature of
+// the search: --signature checks it and exits with 1 when it differs, so a
+// change that should not alter the tree can be verified. --perf counts hardware
+// events (cycles, instructions, cache, branch and TLB misses) with Linux
+// perf_event_open. --json writes the per-position and total figures, with the
+// events of each position and each of its iterations under --perf, for
+// tracking across commits.
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "chess/util.h"
+#include "chess/zobrist.h"
+#include "engine/bench.h"
+
+static void write_json(std::ostream& out, int depth, const bench::Result& result) {
+    out << "{\n  \"depth\": " << depth << ",\n  \"threads\": 1,\n  \"hash_mb\": " << bench::HASH_MB
+        << ",\n  \"positions\": [\n";
+    for (size_t i = 0; i < result.positions.size(); ++i) {
+        const bench::PositionResult& p = result.positions[i];
+        out << "    {\"fen\": \"" << p.fen << "\", \"nodes\": " << p.nodes << ", \"ms\": " << p.ms
+            << ", \"bestmove\": \"" << util::move_to_string(p.best_move) << "\"";
+        if (p.counters.available) {
+            out << ",\n     \"counters\": " << p.counters.to_json() << ",\n     \"depths\": [";
+            for (size_t d = 0; d < p.depths.size(); ++d) {
+                out << (d ? ", " : "") << "{\"depth\": " << p.depths[d].depth
+                    << ", \"counters\": " << p.depths[d].counts.to_json() << "}";
+            }
+            out << "]";
+        }
+        out << "}" << (i + 1 < result.positions.size() ? "," : "") << "\n";
+    }
+    out << "  ],\n  \"total\": {\"nodes\": " << result.nodes << ", \"ms\": " << result.ms
+        << ", \"nps\": " << result.nps();
+    if (result.counters.available) out << ", \"counters\": " << result.counters.to_json();
+    out << "}\n}\n";
+}
+
+int main(int argc, char* argv[]) {
+    chess::init();
+    Zobrist::init_zobrist_keys();
+
+    int depth = bench::DEFAULT_DEPTH;
+    uint64_t signature = 0;
+    std::string json_path;
+    bool perf = false;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--signature" && has_value) signature = std::stoull(argv[++i]);
+        else if (arg == "--json" && has_value) json_path = argv[++i];
+        else if (arg == "--perf") perf = true;
+        else if (arg[0] != '-') depth = std::max(1, std::stoi(arg));
+        else {
+            std::cerr << "usage: search_benchmark [depth] [--signature nodes] [--perf] [--json file|-]" << std::endl;
+            return 1;
+        }
+    }
+
+    Search search(bench::HASH_MB);
+    if (perf) {
+        PerfCounters probe;
+        if (!probe.available()) std::cerr << "no hardware counters, " << probe.error() << std::endl;
+        search.perf_counters = probe.available();
+    }
+    const bench::Result result = bench::run(search, depth, std::cout);
+    bench::print_summary(result, std::cout);
+
+    if (json_path == "-") {
+        write_json(std::cout, depth, result);
+    } else if (!json_path.empty()) {
+        std::ofstream out(json_path);
+        write_json(out, depth, result);
+        if (!out) {
+            std::cerr << "cannot write " << json_path << std::endl;
+            return 1;
+        }
+    }
+    if (signature != 0 && signature != result.nodes) {
+        std::cerr << "signature mismatch: expected " << signature << ", searched " << result.nodes << std::endl;
+        return 1;
+    }
+    return 0;
+}
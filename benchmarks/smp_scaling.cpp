@@ -0,0 +1,59 @@
+// Lazy SMP time-to-depth: searches a few positions to a fixed depth with
+// 1/2/4/8/16/32 threads and reports the wall time and speedup over one thread.
+// Time-to-depth only measures how fast the threads reach a depth; the Elo gain
+// of extra threads has to be measured with matches.
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "chess/board.h"
+#include "chess/zobrist.h"
+#include "engine/search.h"
+
+static const char* FENS[] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+};
+
+static const int DEPTH = 8;
+static const int MAX_TIME_MS = 10 * 60 * 1000;   // the depth limit ends the search
+
+int main() {
+    chess::init();
+    Zobrist::init_zobrist_keys();
+
+    std::cout << "depth " << DEPTH << ", " << std::thread::hardware_concurrency() << " hardware threads\n";
+    std::cout << std::setw(8) << "threads" << std::setw(12) << "time s" << std::setw(14) << "nodes" << std::setw(12) << "speedup" << "\n";
+
+    double one_thread_time = 0;
+    for (int threads : {1, 2, 4, 8, 16, 32}) {
+        Search search(64);
+        search.set_threads(threads);
+        search.quiet = true;
+
+        double seconds = 0;
+        uint64_t nodes = 0;
+        for (const char* fen : FENS) {
+            Board board;
+            std::string f = fen;
+            board.set_fen(f);
+            search.TT.clear();
+
+            auto start = std::chrono::steady_clock::now();
+            search.start_search(board, DEPTH, MAX_TIME_MS, 0, 0, 0, 0);
+            seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            nodes += search.nodes_searched;
+        }
+        if (threads == 1) one_thread_time = seconds;
+
+        std::cout << std::setw(8) << threads
+                  << std::setw(12) << std::fixed << std::setprecision(2) << seconds
+                  << std::setw(14) << nodes
+                  << std::setw(11) << std::setprecision(2) << one_thread_time / seconds << "x\n";
+    }
+    return 0;
+}
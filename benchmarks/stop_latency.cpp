@@ -0,0 +1,77 @@
+// Stop latency: how long the search takes to return a best move after UCI "stop"
+// (stopSearch set from another thread), and how far a movetime search overruns
+// its deadline. Both are measured for 1/2/4/8 threads.
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "chess/board.h"
+#include "chess/zobrist.h"
+#include "engine/search.h"
+
+static const char* FENS[] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+};
+
+static const int STOP_AFTER_MS = 300;
+static const int MOVETIME_MS = 200;
+static const int LONG_MOVETIME_MS = 60 * 1000;   // "stop" ends these searches
+
+using Clock = std::chrono::steady_clock;
+
+static double ms_since(Clock::time_point t) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - t).count();
+}
+
+int main() {
+    chess::init();
+    Zobrist::init_zobrist_keys();
+
+    std::cout << std::setw(8) << "threads" << std::setw(16) << "stop avg ms" << std::setw(16) << "stop max ms"
+              << std::setw(20) << "overrun avg ms" << std::setw(20) << "overrun max ms" << "\n";
+
+    for (int threads : {1, 2, 4, 8}) {
+        Search search(64);
+        search.set_threads(threads);
+        search.quiet = true;
+
+        double stop_sum = 0, stop_max = 0, overrun_sum = 0, overrun_max = 0;
+        for (const char* fen : FENS) {
+            Board board;
+            std::string f = fen;
+            board.set_fen(f);
+
+            // "stop" from another thread while a long search is running
+            search.TT.clear();
+            Clock::time_point stop_time;
+            std::thread searcher([&] { search.start_search(board, 64, LONG_MOVETIME_MS, 0, 0, 0, 0); });
+            std::this_thread::sleep_for(std::chrono::milliseconds(STOP_AFTER_MS));
+            stop_time = Clock::now();
+            search.stopSearch.store(true);
+            searcher.join();
+            double stop_ms = ms_since(stop_time);
+
+            // Deadline set only by movetime
+            search.TT.clear();
+            auto start = Clock::now();
+            search.start_search(board, 64, MOVETIME_MS, 0, 0, 0, 0);
+            double overrun_ms = ms_since(start) - MOVETIME_MS;
+
+            stop_sum += stop_ms;
+            stop_max = std::max(stop_max, stop_ms);
+            overrun_sum += overrun_ms;
+            overrun_max = std::max(overrun_max, overrun_ms);
+        }
+
+        const int n = sizeof(FENS) / sizeof(FENS[0]);
+        std::cout << std::setw(8) << threads << std::fixed << std::setprecision(3)
+                  << std::setw(16) << stop_sum / n << std::setw(16) << stop_max
+                  << std::setw(20) << overrun_sum / n << std::setw(20) << overrun_max << "\n";
+    }
+    return 0;
+}
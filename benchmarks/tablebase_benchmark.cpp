@@ -0,0 +1,112 @@
+// Tablebase probe latency: probes every position of small trees from a set of
+// endgames and reports nanoseconds per WDL and DTM probe, and a search of each
+// endgame with and without the tables. Pass a directory of tables (tbgen
+// output) to use them; otherwise the 3-man tables are generated first.
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "chess/board.h"
+#include "chess/zobrist.h"
+#include "engine/search.h"
+#include "engine/tablebase.h"
+#include "benchmark_util.h"
+
+static const char* FENS[] = {
+    "8/8/8/3k4/8/8/1P6/3K4 w - - 0 1",
+    "8/2k5/8/8/3K4/8/5R2/8 w - - 0 1",
+    "8/8/8/4k3/8/8/8/3QK3 b - - 0 1",
+    "8/8/5k2/8/2r5/8/3KQ3/8 w - - 0 1",
+    "8/8/3k4/3p4/8/3P4/3K4/8 w - - 0 1",
+};
+
+static const int TREE_DEPTH = 3;
+static const int RUNS = 20;
+static const int SEARCH_DEPTH = 10;
+
+int main(int argc, char* argv[]) {
+    chess::init();
+    Zobrist::init_zobrist_keys();
+
+    std::string error;
+    std::string dir = argc > 1 ? argv[1] : "tablebase_benchmark_dir";
+    if (argc < 2) {
+        std::filesystem::create_directories(dir);
+        for (const std::string& name : tb::all_tables(3)) {
+            tb::GenerateStats stats;
+            if (!tb::load_table(dir, name, error) && !tb::generate(name, dir, 1, stats, error)) {
+                std::cerr << error << std::endl;
+                return 1;
+            }
+        }
+    }
+    if (!tb::load(dir, error) || tb::tables_loaded() == 0) {
+        std::cerr << "no tables in " << dir << std::endl;
+        return 1;
+    }
+    std::cout << tb::tables_loaded() << " tables, up to " << tb::max_pieces() << " pieces\n";
+
+    std::vector<Board> positions;
+    for (const char* fen : FENS) {
+        Board board;
+        std::string f = fen;
+        board.set_fen(f);
+        collect(board, TREE_DEPTH, positions);
+    }
+
+    uint64_t hits = 0;
+    int64_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int run = 0; run < RUNS; ++run) {
+        for (const Board& board : positions) {
+            tb::WDL wdl;
+            if (tb::probe_wdl(board, wdl)) ++hits, checksum += wdl;
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "wdl: " << seconds * 1e9 / (positions.size() * RUNS) << " ns/probe, " << hits / RUNS << " of "
+              << positions.size() << " positions covered (checksum " << checksum << ")\n";
+
+    checksum = 0;
+    start = std::chrono::steady_clock::now();
+    for (int run = 0; run < RUNS; ++run) {
+        for (const Board& board : positions) {
+            tb::Probe probe;
+            if (tb::probe_dtm(board, probe)) checksum += probe.wdl * probe.plies;
+        }
+    }
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "dtm: " << seconds * 1e9 / (positions.size() * RUNS) << " ns/probe (checksum " << checksum << ")\n";
+
+    // The same searches without and with the tables: captures and promotions
+    // into covered material end in a probe (positions covered at the root are
+    // answered by probe_root without searching)
+    for (bool tables : {false, true}) {
+        if (tables) tb::load(dir, error);
+        else tb::unload();
+        Search search(16);
+        search.quiet = true;
+        double seconds = 0;
+        uint64_t nodes = 0, tb_hits = 0;
+        for (const char* fen : FENS) {
+            Board board;
+            std::string f = fen;
+            board.set_fen(f);
+            search.TT.clear();
+
+            auto start = std::chrono::steady_clock::now();
+            search.start_search(board, SEARCH_DEPTH, 0, 0, 0, 0, 0);
+            seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            nodes += search.nodes_searched;
+            tb_hits += search.tb_hits();
+        }
+        std::cout << (tables ? "search with tables:    " : "search without tables: ") << std::fixed << std::setprecision(2)
+                  << seconds << " s, " << nodes << " nodes, " << tb_hits << " tbhits\n";
+        std::cout.unsetf(std::ios::fixed);
+    }
+    tb::unload();
+    if (argc < 2) std::filesystem::remove_all(dir);
+    return 0;
+}
@@ -0,0 +1,99 @@
+// Transposition table contention: the lock-free table against the previous
+// mutex-striped table, with 1/2/4/8/16 threads doing a probe/store mix.
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+#include "engine/transposition.h"
+
+// The table this engine used before the lock-free one: one slot per index,
+// 256 mutexes, depth-preferred replacement.
+class MutexTranspositionTable {
+    std::unique_ptr<TTEntry[]> table;
+    size_t num_entries;
+    std::vector<std::mutex> locks;
+    static const size_t NumLocks = 256;
+
+public:
+    MutexTranspositionTable(size_t size_mb) : locks(NumLocks) {
+        num_entries = (size_mb * 1024 * 1024) / sizeof(TTEntry);
+        table = std::make_unique<TTEntry[]>(num_entries);
+    }
+
+    void store(const TTEntry& entry) {
+        uint64_t index = entry.key % num_entries;
+        std::lock_guard<std::mutex> guard(locks[entry.key % NumLocks]);
+        if (entry.depth >= table[index].depth || table[index].key == 0) table[index] = entry;
+    }
+
+    bool probe(uint64_t key, TTEntry& entry) {
+        uint64_t index = key % num_entries;
+        std::lock_guard<std::mutex> guard(locks[key % NumLocks]);
+        entry = table[index];
+        return entry.key == key;
+    }
+};
+
+static const size_t TABLE_MB = 64;
+static const size_t OPS_PER_THREAD = 2'000'000;
+static const size_t KEY_POOL = 1 << 20;   // shared keys, so threads hit the same entries
+
+template <typename Table>
+static double run(Table& tt, int threads, const std::vector<uint64_t>& keys, uint64_t& hits) {
+    std::vector<std::thread> workers;
+    std::vector<uint64_t> thread_hits(threads, 0);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            std::mt19937_64 rng(t + 1);
+            uint64_t local_hits = 0;
+            for (size_t i = 0; i < OPS_PER_THREAD; ++i) {
+                const uint64_t r = rng();
+                const uint64_t key = keys[r % KEY_POOL];
+                TTEntry entry{};
+                // Search-like mix: every node probes, roughly half of them store
+                if (tt.probe(key, entry)) local_hits++;
+                if (r & (1ULL << 40)) {
+                    entry = { key, (uint8_t)(r >> 48 & 31), (int64_t)(r >> 32 & 1023) - 512, TTEntry::EXACT, chess::Move(r & 63, (r >> 6) & 63) };
+                    tt.store(entry);
+                }
+            }
+            thread_hits[t] = local_hits;
+        });
+    }
+    for (auto& w : workers) w.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    hits = 0;
+    for (uint64_t h : thread_hits) hits += h;
+    return (double)(threads * OPS_PER_THREAD) / seconds / 1e6;
+}
+
+int main() {
+    std::vector<uint64_t> keys(KEY_POOL);
+    std::mt19937_64 rng(12345);
+    for (auto& k : keys) k = rng();
+
+    std::cout << "table " << TABLE_MB << " MB, " << OPS_PER_THREAD << " probes per thread, "
+              << std::thread::hardware_concurrency() << " hardware threads\n";
+    std::cout << std::setw(8) << "threads" << std::setw(16) << "mutex Mops/s" << std::setw(20) << "lock-free Mops/s" << std::setw(10) << "speedup" << "\n";
+
+    for (int threads : {1, 2, 4, 8, 16}) {
+        uint64_t mutex_hits = 0, lockfree_hits = 0;
+        MutexTranspositionTable mutex_tt(TABLE_MB);
+        TranspositionTable lockfree_tt(TABLE_MB);
+        const double mutex_mops = run(mutex_tt, threads, keys, mutex_hits);
+        const double lockfree_mops = run(lockfree_tt, threads, keys, lockfree_hits);
+
+        std::cout << std::setw(8) << threads
+                  << std::setw(16) << std::fixed << std::setprecision(2) << mutex_mops
+                  << std::setw(20) << lockfree_mops
+                  << std::setw(9) << std::setprecision(2) << lockfree_mops / mutex_mops << "x\n";
+    }
+    return 0;
+}
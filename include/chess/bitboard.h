@@ -103,6 +103,8 @@ inline void print_bitboard(uint64_t bb) {
 
 extern uint64_t Between[chess::SQUARE_NB][chess::SQUARE_NB];
 extern uint64_t Rays[chess::SQUARE_NB][chess::SQUARE_NB];
+// Full edge-to-edge line through both squares (0 if not aligned), used for pin rays
+extern uint64_t Line[chess::SQUARE_NB][chess::SQUARE_NB];
 
 // generator (can be used to fill the tables at program init if not constexpr-hardened)
 void generate_between_and_ray_tables() noexcept;
@@ -6,9 +6,21 @@
 #include <string>
 #include "types.h"
 #include "bitboard.h"
+#include "nnue.h"
+#include "psqt.h"
 
 constexpr uint64_t ONE = 1ULL;
 
+// Checking information for the side to move, computed on demand.
+// check_squares[pt]: squares from which a piece of type pt attacks the enemy king.
+// discoverers: our pieces that are the only blocker between one of our sliders
+// and the enemy king, so moving them off that line gives a discovered check.
+struct CheckInfo {
+    uint64_t check_squares[chess::PIECE_TYPE_NB];
+    uint64_t discoverers;
+    chess::Square enemy_king_sq;
+};
+
 // ---------- Board state ----------
 class Board {
 public:
@@ -44,14 +56,20 @@ public:
 
     // --- Zobrist hash
     uint64_t zobrist_key;
-    uint64_t zobrist_pawn_key; // optional pawn hash
-    int32_t material_white;
+    uint64_t zobrist_pawn_key; // pawns only, key of the pawn hash table
+    // --- Running evaluation sums, updated on every piece add/remove/move
+    int32_t material_white;   // non-king midgame material
     int32_t material_black;
-    int32_t game_phase;
+    int32_t game_phase;       // not clamped: promotions can take it past TOTAL_PHASE
+    chess::Score psq_score;   // material + PST, white minus black
 
     // --- Undo stack
     std::vector<chess::Undo> undo_stack;
 
+    // --- NNUE accumulators, one per ply (undo_stack.size() + 1 while NNUE is on).
+    // Mutable: evaluation only fills in accumulators that make_move left lazy.
+    mutable std::vector<nnue::Accumulator> accumulators;
+
     // Cached occupancies
     uint64_t white_occupied;
     uint64_t black_occupied;
@@ -100,6 +118,9 @@ public:
     void clear();
     void set_fen(std::string &fen_cstr);
     std::string to_fen() const;
+    // Derives king squares, occupancies, scores, pins and keys from the pieces,
+    // side, castling and en passant; for code that fills those in directly
+    void finish_setup();
 
     // Debug
     void print_board() const;
@@ -112,10 +133,20 @@ public:
     bool isempty(chess::Square sq) const { return board_array[sq] == chess::NO_PIECE; }
     chess::Piece piece_on_sq(chess::Square sq) const { return board_array[sq]; }
     bool square_attacked(chess::Square sq, bool by_white) const; // uses attack tables
+    bool square_attacked(chess::Square sq, bool by_white, uint64_t occupancy) const; // sliders see through removed pieces
     uint64_t attackers_to(chess::Square sq, bool by_white) const;
     chess::PieceType get_least_value_attacking_piece_type_on_sq(chess::Square sq, bool by_white) const;
     bool is_position_legal();
 
+    // Check detection before make_move
+    CheckInfo compute_check_info() const;
+    bool gives_check(const chess::Move& move, const CheckInfo& ci) const;
+    bool gives_check(const chess::Move& move) const { return gives_check(move, compute_check_info()); }
+
+    // Recomputes material, phase and psq_score from the bitboards (set_fen, and
+    // after new evaluation parameters refill the psqt tables)
+    void refresh_scores();
+
 private:
     //assumes to_sq is empty
     inline void move_piece_bb(chess::Piece piece, chess::Square from_sq, chess::Square to_sq) {
@@ -134,25 +165,17 @@ private:
         if (piece == chess::WK || piece == chess::BK) update_king_squares_from_bitboards();
     }
 
-    inline void update_game_phase() {
-        this->game_phase = 0;
-
-        // White pieces
-        this->game_phase += util::count_bits(this->bitboard[chess::WP]) * util::phase_values[chess::PAWN];
-        this->game_phase += util::count_bits(this->bitboard[chess::WN]) * util::phase_values[chess::KNIGHT];
-        this->game_phase += util::count_bits(this->bitboard[chess::WB]) * util::phase_values[chess::BISHOP];
-        this->game_phase += util::count_bits(this->bitboard[chess::WR]) * util::phase_values[chess::ROOK];
-        this->game_phase += util::count_bits(this->bitboard[chess::WQ]) * util::phase_values[chess::QUEEN];
-
-        // Black pieces
-        this->game_phase += util::count_bits(this->bitboard[chess::BP]) * util::phase_values[chess::PAWN];
-        this->game_phase += util::count_bits(this->bitboard[chess::BN]) * util::phase_values[chess::KNIGHT];
-        this->game_phase += util::count_bits(this->bitboard[chess::BB]) * util::phase_values[chess::BISHOP];
-        this->game_phase += util::count_bits(this->bitboard[chess::BR]) * util::phase_values[chess::ROOK];
-        this->game_phase += util::count_bits(this->bitboard[chess::BQ]) * util::phase_values[chess::QUEEN];
-
-        // Clamp game phase to a valid range
-        this->game_phase = std::max(0, std::min(this->game_phase, util::TOTAL_PHASE));
+    // Running sums for a piece appearing on or leaving sq
+    inline void add_piece_score(chess::Piece piece, chess::Square sq) {
+        psq_score += psqt::table[piece][sq];
+        (chess::color_of(piece) == chess::WHITE ? material_white : material_black) += psqt::material[piece];
+        game_phase += util::phase_values[chess::type_of(piece)];
+    }
+
+    inline void remove_piece_score(chess::Piece piece, chess::Square sq) {
+        psq_score -= psqt::table[piece][sq];
+        (chess::color_of(piece) == chess::WHITE ? material_white : material_black) -= psqt::material[piece];
+        game_phase -= util::phase_values[chess::type_of(piece)];
     }
 
     inline void update_occupancies() {
@@ -163,6 +186,13 @@ private:
 
     void compute_pins_and_checks();
 
+    // Records the piece changes of a move for the NNUE accumulator stack
+    void push_accumulator(const chess::Move& mv, chess::Piece moving_piece, chess::Piece captured_piece);
+
+    // Cross-checks the incremental zobrist_key against a full recompute.
+    // Only does work when the engine is built with VERIFY_ZOBRIST.
+    void verify_zobrist_key() const;
+
     //Assumes 0-Based indexing of the board, a1 = 0 (from bottom left). 0-based indexing for rank and files too
     inline chess::Square get_square_from_rank_file(int8_t rank, int8_t file) { return (chess::Square)(8 * rank + file); }
 };
@@ -2,15 +2,51 @@
 #include "types.h"
 #include "board.h"
 #include "bitboard.h"
-#include <vector>
 namespace MoveGen {
-    extern std::vector<chess::Move> moveList;
+    // CAPTURES: captures, en passant and all promotions. QUIETS: everything else,
+    // castling included. ALL: both. CAPTURES and QUIETS partition ALL.
+    enum GenType : uint8_t {
+        CAPTURES,
+        QUIETS,
+        ALL
+    };
 
-    void generate_pawn_moves(const Board& B, std::vector<chess::Move>& moveList, bool capturesOnly);
-    void generate_knight_moves(const Board& B, std::vector<chess::Move>& moveList, bool capturesOnly);
-    void generate_king_moves(const Board& B, std::vector<chess::Move>& moveList, bool capturesOnly);
-    void generate_orthogonal_sliders_moves(const Board& B, std::vector<chess::Move>& moveList, bool capturesOnly);
-    void generate_diagonal_sliders_moves(const Board& B, std::vector<chess::Move>& moveList, bool capturesOnly);
+    // legalOnly: use the pin rays and check mask from Board::compute_pins_and_checks
+    // so every generated move is legal. Otherwise moves are pseudo-legal and the
+    // caller must filter with make_move + is_position_legal.
+    void generate_pawn_moves(const Board& B, chess::MoveList& moveList, GenType type, bool legalOnly);
+    void generate_knight_moves(const Board& B, chess::MoveList& moveList, GenType type, bool legalOnly);
+    void generate_king_moves(const Board& B, chess::MoveList& moveList, GenType type, bool legalOnly);
+    void generate_orthogonal_sliders_moves(const Board& B, chess::MoveList& moveList, GenType type, bool legalOnly);
+    void generate_diagonal_sliders_moves(const Board& B, chess::MoveList& moveList, GenType type, bool legalOnly);
 
-    void init(const Board& B, std::vector<chess::Move>& moveList, bool capturesOnly);
+    void init(const Board& B, chess::MoveList& moveList, GenType type, bool legalOnly);
+
+    // Legal non-capturing, non-promoting moves that give check, for quiescence search.
+    void generate_quiet_checks(const Board& B, chess::MoveList& moveList, const CheckInfo& ci);
+
+    // True if move is legal in this position. Only the generator for the moving
+    // piece type is run, so this is cheap enough to validate TT moves and killers.
+    bool is_legal(const Board& B, chess::Move move);
+
+    // Destination squares for non-pawn moves of the given generation type.
+    inline uint64_t gen_mask(const Board& B, GenType type) {
+        const uint64_t enemies = B.white_to_move ? B.black_occupied : B.white_occupied;
+        if (type == CAPTURES) return enemies;
+        if (type == QUIETS) return ~B.occupied;
+        return enemies | ~B.occupied;
+    }
+
+    // Destination mask for non-king moves: when in check only captures of the
+    // checker or interpositions on the check ray are allowed.
+    inline uint64_t evasion_mask(const Board& B, bool legalOnly) {
+        return (legalOnly && B.checks) ? B.check_mask : ~0ULL;
+    }
+
+    // A pinned piece may only move along the line through its own king.
+    inline uint64_t pin_mask(const Board& B, chess::Square from, bool legalOnly) {
+        if (!legalOnly || !(B.pinned & (1ULL << from))) return ~0ULL;
+        const chess::Square king_sq = B.white_to_move ? B.white_king_sq : B.black_king_sq;
+        return chess::Line[king_sq][from];
+    }
 };
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "types.h"
+
+class Board;
+
+/**
+ * @file nnue.h
+ * @brief Optional NNUE evaluation with incrementally updated accumulators.
+ *
+ * Network: HalfKP (king square x non-king piece x square, per perspective)
+ * -> 2 x L1 int16 accumulators -> clipped ReLU -> one output. Board keeps one
+ * Accumulator per ply; make_move only records which pieces changed and the
+ * accumulator is brought up to date lazily when a position is evaluated.
+ *
+ * Weights file (little-endian):
+ *   uint32 magic 'HCNN', uint32 version, uint32 INPUTS, uint32 L1
+ *   int16  feature biases[L1]
+ *   int16  feature weights[INPUTS][L1]
+ *   int16  output weights[2 * L1]   (side to move first)
+ *   int32  output bias
+ */
+namespace nnue {
+
+constexpr uint32_t MAGIC = 0x4E4E4348; // "HCNN"
+constexpr uint32_t VERSION = 1;
+constexpr int INPUTS = 64 * 641;       // HalfKP
+constexpr int L1 = 256;
+constexpr int QA = 255;                // accumulator quantisation
+constexpr int QB = 64;                 // output weight quantisation
+constexpr int SCALE = 400;             // network output to centipawns
+
+// Pieces added and removed by one move. A king move needs a full refresh of
+// that side's perspective, since every HalfKP feature depends on the king square.
+struct DirtyPiece {
+    chess::Piece add_piece[2], sub_piece[2];
+    chess::Square add_sq[2], sub_sq[2];
+    uint8_t n_add = 0, n_sub = 0;
+    bool refresh[chess::COLOR_NB] = {false, false};
+
+    inline void add(chess::Piece p, chess::Square sq) { add_piece[n_add] = p; add_sq[n_add++] = sq; }
+    inline void sub(chess::Piece p, chess::Square sq) { sub_piece[n_sub] = p; sub_sq[n_sub++] = sq; }
+};
+
+struct alignas(64) Accumulator {
+    int16_t values[chess::COLOR_NB][L1];
+    bool computed[chess::COLOR_NB] = {false, false};
+    DirtyPiece dirty; // changes made by the move that led to this ply
+
+    Accumulator() {} // user-provided so a push does not zero the values
+};
+
+/**
+ * @brief Loads a network from a weights file. On failure the previous network
+ * (if any) is kept and an error message is returned through error.
+ */
+bool load(const std::string& path, std::string& error);
+
+// True once a network has been loaded
+bool loaded();
+
+// Selects NNUE (true) or the classic evaluation (false); needs a loaded network
+bool set_enabled(bool on);
+
+extern bool use_nnue;
+inline bool enabled() { return use_nnue; }
+
+// Name of the SIMD kernels picked at runtime: "avx2", "sse4.1" or "scalar"
+const char* simd_name();
+
+/**
+ * @brief Evaluates the position from the side to move's perspective, bringing
+ * the board's accumulator stack up to date first.
+ */
+int evaluate(const Board& b);
+
+} // namespace nnue
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "chess/board.h"
+#include "chess/types.h"
+
+/**
+ * @file perft.h
+ * @brief Move generation counts (perft) and the suites that check them.
+ *
+ * The last ply is bulk-counted: the legal move generator's list size is the
+ * number of leaves, so the moves one ply above the horizon are never made.
+ */
+namespace perft {
+
+// Leaf nodes depth plies below b
+uint64_t count(Board& b, int depth);
+
+// Lock-free table of subtree counts keyed by Zobrist key and depth.
+//
+// Each slot is two 64-bit words: `data` packs nodes(56) | depth(8) and `key`
+// holds zobrist_key ^ data, both read and written with relaxed atomics as in
+// the transposition table. A torn read fails the XOR check and counts as a
+// miss. Four slots make a 64-byte cluster; a store replaces the same
+// position and depth, or else the shallowest slot.
+class Hash {
+private:
+    struct Slot {
+        std::atomic<uint64_t> key;
+        std::atomic<uint64_t> data;
+    };
+    static constexpr int ClusterSize = 4;
+    struct alignas(64) Cluster {
+        Slot slots[ClusterSize];
+    };
+
+    std::unique_ptr<Cluster[]> table;
+    size_t num_clusters;
+
+    inline Cluster& cluster_for(uint64_t key) const {
+        return table[(size_t)(((unsigned __int128)key * num_clusters) >> 64)];
+    }
+
+public:
+    explicit Hash(size_t size_mb);
+    void clear();
+    size_t size_bytes() const { return num_clusters * sizeof(Cluster); }
+
+    bool probe(uint64_t key, int depth, uint64_t& nodes) const;
+    void store(uint64_t key, int depth, uint64_t nodes);
+};
+
+// count with subtrees of depth 2 and more looked up in and stored to hash
+uint64_t count(Board& b, int depth, Hash& hash);
+
+struct ParallelStats {
+    int split_plies = 0;  // plies below the root the tasks start at
+    size_t positions = 0; // positions at that ply
+    size_t tasks = 0;     // distinct ones among them, each counted once
+};
+
+/**
+ * @brief count on threads threads, sharing hash when it is not null.
+ *
+ * The tree is split a ply at a time until there are at least TASKS_PER_THREAD
+ * tasks per thread (or the tasks would get too shallow). Transpositions at the
+ * split ply become one task with a multiplicity. Threads claim tasks, largest
+ * first by move count, from a shared atomic cursor, so a thread that finishes
+ * early takes the next task instead of idling behind an uneven root move.
+ */
+uint64_t count_parallel(const Board& b, int depth, size_t threads, Hash* hash, ParallelStats* stats = nullptr);
+constexpr size_t TASKS_PER_THREAD = 64;
+
+// Leaf nodes below each legal move of b, for comparing against another engine's "divide"
+struct Division {
+    chess::Move move;
+    uint64_t nodes;
+};
+std::vector<Division> divide(Board& b, int depth);
+
+// A suite position: "<fen> ;D1 20 ;D2 400 ;D3 8902". expected[d - 1] is the
+// count at depth d, 0 when the line does not give it.
+struct SuiteEntry {
+    std::string fen;
+    std::vector<uint64_t> expected;
+    int line = 0;
+
+    int max_depth() const { return int(expected.size()); }
+};
+
+// Reads a suite file; blank lines and lines starting with '#' are skipped
+bool load_suite(const std::string& path, std::vector<SuiteEntry>& entries, std::string& error);
+
+} // namespace perft
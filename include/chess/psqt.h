@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+#include "types.h"
+
+/**
+ * @file psqt.h
+ * @brief Material + piece-square values per (piece, square), used by Board to
+ * keep running evaluation sums in make_move/unmake_move.
+ *
+ * The values come from the evaluation parameters, so the tables are defined and
+ * filled in src/engine/evaluate.cpp.
+ */
+namespace psqt {
+
+// [chess::Piece][square] material + PST, positive for white pieces and negative for black
+extern chess::Score table[16][64];
+
+// [chess::Piece] midgame material value, zero for kings and unused codes
+extern int32_t material[16];
+
+} // namespace psqt
@@ -10,6 +10,7 @@
  * dependencies between other modules.
  */
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 
@@ -103,7 +104,7 @@ constexpr PieceType type_of(Piece p) {
 // Helper function to get the Color of a Piece
 constexpr Color color_of(Piece p) {
     if (p == NO_PIECE) return COLOR_NONE;
-    return Color(p & colorMask); // 4th bit = 0 -> White, 1 -> Black
+    return Color((p & colorMask) >> 3); // 4th bit = 0 -> White, 1 -> Black
 }
 
 // Helper function to construct a Piece from a PieceType and Color
@@ -179,9 +180,73 @@ struct Move {   //          LSB                          MSB
     bool is_null() const { return m == 0; }
 };
 
+// A move plus its ordering score, so the orderer can sort in place.
+struct ScoredMove : Move {
+    int score;
+};
+
+// Upper bound on legal moves in any chess position (the known maximum is 218).
+const int MAX_MOVES = 256;
+
+// Fixed-capacity move list that lives on the stack. Move generation runs at
+// every node, so this avoids a heap allocation per node. The storage sits in an
+// anonymous union so constructing a list does not zero all 256 entries.
+class MoveList {
+public:
+    MoveList() : count(0) {}
+
+    void push_back(const Move& move) {
+        moves[count].m = move.m;
+        moves[count].score = 0;
+        ++count;
+    }
+    void clear() { count = 0; }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    ScoredMove& operator[](size_t i) { return moves[i]; }
+    const ScoredMove& operator[](size_t i) const { return moves[i]; }
+
+    ScoredMove* begin() { return moves; }
+    ScoredMove* end() { return moves + count; }
+    const ScoredMove* begin() const { return moves; }
+    const ScoredMove* end() const { return moves + count; }
+
+private:
+    union { ScoredMove moves[MAX_MOVES]; };
+    size_t count;
+};
+
+// Score is a 32-bit signed integer representing the evaluation in centipawns.
+// It packs both middlegame and endgame scores, as piece values and positional
+// bonuses change throughout the game: eg in the upper 16 bits, mg in the lower.
+// One integer add, subtract or multiply updates both halves; the halves stay
+// correct as long as each fits in 16 bits.
+struct Score {
+    uint32_t value = 0; // unsigned so that wrapping between the halves is defined
+
+    constexpr Score() = default;
+    constexpr Score(int mg, int eg) : value((uint32_t(eg) << 16) + uint32_t(mg)) {}
+
+    constexpr int mg() const { return int16_t(uint16_t(value)); }
+    // The low half borrowed from the high one when mg is negative
+    constexpr int eg() const { return int16_t(uint16_t((value + 0x8000u) >> 16)); }
+
+    constexpr Score& operator+=(Score s) { value += s.value; return *this; }
+    constexpr Score& operator-=(Score s) { value -= s.value; return *this; }
+};
+
+// Operator overloads for convenient Score arithmetic
+constexpr Score operator+(Score s1, Score s2) { return s1 += s2; }
+constexpr Score operator-(Score s1, Score s2) { return s1 -= s2; }
+constexpr Score operator-(Score s) { return Score() - s; }
+constexpr Score operator*(int i, Score s) { s.value *= uint32_t(i); return s; }
+
 // ---------- Minimal undo record (compact) ----------
 struct Undo {
     uint64_t zobrist_before;      // full hash
+    uint64_t pawn_key_before;     // pawn-only hash
     uint16_t captured_piece_and_halfmove; 
         // lower 4 bits: captured piece code
         // upper 12 bits: halfmove clock (halfmove clock <= 50)
@@ -195,6 +260,9 @@ struct Undo {
     bool double_check;
     uint64_t check_mask; // rays + checker squares
     int game_phase;
+    int32_t material_white;
+    int32_t material_black;
+    Score psq_score;
     Undo() = default;
 };
 
@@ -208,18 +276,6 @@ struct Undo {
 // A signed 8-bit integer is more than sufficient.
 using Depth = int8_t;
 
-// Score is a 32-bit signed integer representing the evaluation in centipawns.
-// We use a struct to hold both middlegame and endgame scores, as piece
-// values and positional bonuses change throughout the game.
-struct Score {
-    int16_t mg;
-    int16_t eg;
-};
-
-// Operator overloads for convenient Score arithmetic
-inline Score operator+(Score s1, Score s2) { return { int16_t(s1.mg + s2.mg), int16_t(s1.eg + s2.eg) }; }
-inline Score operator-(Score s1, Score s2) { return { int16_t(s1.mg - s2.mg), int16_t(s1.eg - s2.eg) }; }
-inline Score operator*(int i, Score s) { return { int16_t(i * s.mg), int16_t(i * s.eg) }; }
 
 inline constexpr int square_distance(Square s1, Square s2) {
     const int f1 = s1 % 8;
@@ -14,6 +14,19 @@ public:
      */
     static uint64_t calculate_zobrist_hash(const Board& B);
 
+    /**
+     * @brief Calculates the pawn-only hash (both colours' pawns) from scratch.
+     * Board keeps it incrementally in zobrist_pawn_key for the pawn hash table.
+     */
+    static uint64_t calculate_pawn_hash(const Board& B);
+
+    /**
+     * @brief True if the side to move has a pawn that can capture on the en passant square.
+     * Polyglot only hashes the en passant file in that case, so the incremental
+     * update in Board::make_move and the full recompute both go through here.
+     */
+    static bool en_passant_capturable(const Board& B);
+
     /**
      * @brief Initializes the static Zobrist key arrays. 
      * MUST be called once at program startup.
@@ -35,4 +48,13 @@ public:
     
     // Hashed if it's white's turn
     static uint64_t sideToMove;
+
+    // --- ENGINE-INDEXED VIEWS (filled by init_zobrist_keys) ---
+    // The same Polyglot keys, re-indexed so make_move can XOR without remapping.
+
+    // [chess::Piece][square], zero for unused piece codes
+    static uint64_t pieceKeys[16][64];
+
+    // [chess::CastlingRights mask], XOR of the individual castling keys
+    static uint64_t castlingKeys[16];
 };
\ No newline at end of file
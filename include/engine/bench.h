@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include "chess/types.h"
+#include "engine/search.h"
+
+/**
+ * @file bench.h
+ * @brief Fixed-depth search over a built-in set of positions ("bench").
+ *
+ * The total node count is a signature of the search: it changes with anything
+ * that changes the tree (pruning, ordering, evaluation) and with nothing else,
+ * so a change meant to be a pure speedup must leave it alone. The nodes/s is
+ * the speed figure to compare across builds.
+ *
+ * The count is only reproducible when the search starts from the same state:
+ * run clears the Search and searches on one thread, and the signature also
+ * depends on the TT size (use HASH_MB), the evaluation (classic or NNUE, its
+ * parameters, LazyEvalMargin) and which tablebases are loaded.
+ */
+namespace bench {
+
+constexpr int DEFAULT_DEPTH = 6;
+constexpr size_t HASH_MB = 16;
+
+// The positions searched, in order: openings, middlegames and endgames
+extern const std::vector<std::string> POSITIONS;
+
+struct PositionResult {
+    std::string fen;
+    uint64_t nodes;
+    int64_t ms;
+    chess::Move best_move;
+    // Hardware events, when search.perf_counters is set
+    PerfCounts counters;
+    std::vector<DepthPerf> depths;
+};
+
+struct Result {
+    std::vector<PositionResult> positions;
+    uint64_t nodes = 0;
+    int64_t ms = 0;
+    PerfCounts counters;
+    uint64_t nps() const { return ms > 0 ? nodes * 1000 / ms : 0; }
+};
+
+// Clears search and searches every position to depth on one thread, printing
+// a line per position to log; the search's own info lines are suppressed. The
+// thread count of search is restored afterwards.
+Result run(Search& search, int depth, std::ostream& log);
+
+// The "Total time / Nodes searched / Nodes/second" summary, and the hardware
+// event totals when they were counted
+void print_summary(const Result& result, std::ostream& out);
+
+} // namespace bench
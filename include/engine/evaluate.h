@@ -3,6 +3,8 @@
 #include "chess/util.h"
 #include "chess/types.h"
 #include <array>
+#include <string>
+#include <vector>
 
 namespace eval {
 // Best Practice 1: Create a structure for values that change
@@ -11,8 +13,13 @@ namespace eval {
 struct TaperedScore {
     int mg = 0;
     int eg = 0;
+
+    // The evaluator sums terms as packed scores
+    constexpr operator chess::Score() const { return chess::Score(mg, eg); }
 };
 
+constexpr chess::Score operator*(int i, TaperedScore t) { return i * chess::Score(t); }
+
 // Best Practice 2: Encapsulate all evaluation parameters into a single,
 // comprehensive structure. This makes the entire configuration a single object.
 struct EvalData {
@@ -69,8 +76,9 @@ struct EvalData {
 };
 
 // Best Practice 3: Create a single, compile-time constant instance of the configuration.
-// This ensures all values are in one place and initialized safely.
-constexpr EvalData eval_data = {
+// This ensures all values are in one place and initialized safely. It is the
+// parameter set the engine starts with; others can be loaded at runtime.
+constexpr EvalData default_eval_data = {
     // 1. Material Values
     .material_values = {{
         {0  , 0   },  // NO_PIECE_TYPE
@@ -313,4 +321,93 @@ constexpr EvalData eval_data = {
     }},
 };
 
+// Attack maps for both sides, built in one pass at the start of an evaluation
+// so the piece and king terms never generate the same attacks twice.
+struct EvalContext {
+    uint64_t attacked_by[chess::COLOR_NB][chess::PIECE_TYPE_NB]; // [color][piece type], [color][NO_PIECE_TYPE] = all
+    uint64_t attacked_by2[chess::COLOR_NB];   // squares attacked at least twice
+    uint64_t king_zone[chess::COLOR_NB];      // squares around that side's king
+    uint64_t mobility_area[chess::COLOR_NB];  // squares that side's pieces may count as moves
+    int king_attack_weight[chess::COLOR_NB];  // that side's weighted attacks on the enemy king zone
+    uint64_t attacks_from[64];                // attacks of the piece on each occupied square
+};
+
+void build_context(const Board& b, const EvalData& params, EvalContext& ctx);
+
+// ----------------- Runtime parameters -----------------
+// The parameter set the evaluator reads: default_eval_data until another is
+// set. Only change it between searches.
+extern const EvalData* active;
+
+// Copies data into the active set and refills the psqt tables from it. Boards
+// must call refresh_scores() and pawn tables be cleared afterwards.
+void set_params(const EvalData& data);
+void reset_params();
+
+// Material + PST tables used by Board's running psq_score
+void fill_psqt(const EvalData& data);
+
+// A named run of parameters as it appears in a parameter file: count values,
+// each TaperedScore contributing its mg then its eg.
+struct ParamField {
+    std::string name;
+    TaperedScore* scores = nullptr; // either TaperedScores...
+    int* ints = nullptr;            // ...or plain ints
+    int count = 0;
+
+    int& operator[](int i) const { return scores ? (i % 2 ? scores[i / 2].eg : scores[i / 2].mg) : ints[i]; }
+};
+
+// Every tunable field of data, in file order
+std::vector<ParamField> param_fields(EvalData& data);
+
+// Parameter files are text, one field per line: "<name> <values...>", with
+// '#' starting a comment. Fields a file leaves out keep their defaults, so a
+// file only needs the values it changes.
+bool load_params(const std::string& path, EvalData& data, std::string& error);
+bool save_params(const std::string& path, const EvalData& data, std::string& error);
+
+// ----------------- Trace and profiling -----------------
+// The terms the classic evaluation sums
+enum Term : int {
+    TERM_MATERIAL,      // material and piece-square tables (Board::psq_score)
+    TERM_PAWNS,
+    TERM_KNIGHTS,
+    TERM_BISHOPS,
+    TERM_ROOKS,
+    TERM_QUEENS,
+    TERM_KING_SAFETY,
+    TERM_KING_ACTIVITY,
+    TERM_NB
+};
+extern const char* const TERM_NAMES[TERM_NB];
+
+struct Trace {
+    chess::Score terms[TERM_NB][chess::COLOR_NB]; // each side's own contribution, positive when it helps that side
+    int phase = 0;                                // game phase the mg and eg scores are blended with
+    int score = 0;                                // the evaluation for the side to move
+
+    // A score blended by phase, as the evaluation does before the side to move flips it
+    int tapered(chess::Score s) const { return (s.mg() * phase + s.eg() * (util::TOTAL_PHASE - phase)) / util::TOTAL_PHASE; }
+};
+
+// Evaluates b with the active parameters, recording every term. The evaluator is
+// compiled a second time with tracing on, so Search::evaluate pays nothing for
+// it and the result always equals the classic Search::evaluate.
+int trace(const Board& b, Trace& t);
+// The trace as a table of mg/eg scores for white, black and white - black
+std::string format_trace(const Trace& t);
+
+struct TermCost {
+    std::string name;
+    double ns = 0;     // per position
+    double cycles = 0; // per position, from the time-stamp counter; 0 where there is none
+};
+
+// Times every term (both colours, pawns without a pawn hash) over positions,
+// runs times after a warm-up pass. Material is left out, make_move keeps it up
+// to date; the list ends with the attack maps the terms share and the whole
+// evaluation without a pawn hash.
+std::vector<TermCost> profile_terms(const std::vector<Board>& positions, int runs);
+
 } // namespace eval
\ No newline at end of file
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "chess/movegen.h"
+
+struct SearchWorker;
+
+// Staged move picker. Moves are generated and scored lazily, one stage at a
+// time, so a cutoff on the TT move or an early capture skips the rest:
+//   TT move -> captures with SEE >= 0 -> killers -> quiets -> losing captures
+// The quiescence picker only yields the TT move, captures and promotions with
+// SEE >= 0, and optionally quiet checks.
+class MovePicker {
+public:
+    MovePicker(const Board& b, int ply, const SearchWorker& worker, chess::Move tt_move);
+    MovePicker(const Board& b, chess::Move tt_move, bool quiet_checks);
+    chess::Move get_next_move();
+
+    // Static exchange evaluation of a capture on the board before the move is made.
+    static int64_t see(const Board& board, chess::Move move);
+
+private:
+    enum Stage : uint8_t {
+        TT_MOVE,
+        GEN_CAPTURES,
+        GOOD_CAPTURES,
+        KILLER_1,
+        KILLER_2,
+        GEN_QUIETS,
+        QUIETS,
+        BAD_CAPTURES,
+        DONE,
+
+        QS_TT_MOVE,
+        QS_GEN_CAPTURES,
+        QS_CAPTURES,
+        QS_GEN_CHECKS,
+        QS_CHECKS
+    };
+
+    void generate_captures();
+
+    bool is_special(const chess::Move& move) const;
+
+    const Board& board;
+    const SearchWorker* worker;
+    chess::Move tt_move;
+    chess::Move killers[2];
+    Stage stage;
+    bool quiet_checks = false;
+
+    // Captures occupy [0, end_captures), quiets follow them.
+    chess::MoveList moveList;
+    size_t current_move = 0;
+    size_t end_captures = 0;
+    size_t bad_captures_begin = 0;
+};
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include "chess/types.h"
+
+// Everything evaluation derives from the pawns alone, keyed by Board::zobrist_pawn_key.
+struct PawnEntry {
+    uint64_t key;
+    chess::Score score;        // pawn-only terms, white minus black
+    uint64_t attacks[2];       // [color] squares attacked by that side's pawns
+    uint64_t attack_span[2];   // [color] squares those pawns can ever attack as they advance
+    uint64_t passed[2];        // [color] passed pawns
+};
+
+// Per-thread pawn hash table. Pawn structure rarely changes between sibling
+// nodes, so most evaluations find their pawn terms here. Each SearchWorker owns
+// one, so no synchronisation is needed; the counters are plain for the same reason.
+class PawnTable {
+public:
+    static constexpr size_t SIZE = 1 << 14; // entries, power of two
+
+    PawnTable() : entries(std::make_unique<PawnEntry[]>(SIZE)) { clear(); }
+
+    // Returns the slot for key; found tells whether it already holds that key
+    inline PawnEntry& probe(uint64_t key, bool& found) {
+        PawnEntry& entry = entries[key & (SIZE - 1)];
+        found = (entry.key == key);
+        ++probes;
+        hits += found;
+        return entry;
+    }
+
+    void clear() {
+        // ~0 is not a pawn key in practice, so fresh slots never match
+        for (size_t i = 0; i < SIZE; ++i) entries[i].key = ~0ULL;
+        probes = hits = 0;
+    }
+
+    uint64_t probes = 0;
+    uint64_t hits = 0;
+
+private:
+    std::unique_ptr<PawnEntry[]> entries;
+};
@@ -7,15 +7,39 @@
 #include "chess/types.h"
 #include "chess/movegen.h"
 #include "transposition.h"
+#include "search_worker.h"
 #include "utils/threadpool.h"
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #define DRAW_EVAL 0
-#define CHECKMATE_EVAL -(int)1e7
+#define CHECKMATE_EVAL (-chess::MATE_SCORE) // fits the 16-bit TT score
 #define NEG_INFINITY_EVAL (-(int)1e9)
-#define MAX_PLY 64
+#define MATE_BOUND (chess::MATE_SCORE - 1000) // scores beyond this are mates
+#define TB_WIN_EVAL (MATE_BOUND - 1000) // tablebase wins, less the ply, rank below every mate
+#define LAZY_EVAL_MARGIN 500 // largest swing the non-PST terms of the classic eval make in practice
 
-class MoveOrderer;
+// The TT outlives a single search, so mate scores are stored relative to the
+// node ("mate in n from here") and converted back using the probing ply.
+inline int64_t score_to_tt(int64_t score, int ply) {
+    if (score >= MATE_BOUND) return score + ply;
+    if (score <= -MATE_BOUND) return score - ply;
+    return score;
+}
 
+inline int64_t score_from_tt(int64_t score, int ply) {
+    if (score >= MATE_BOUND) return score - ply;
+    if (score <= -MATE_BOUND) return score + ply;
+    return score;
+}
+
+class MovePicker;
+
+// Search controller. Owns what the workers share (TT, stop flag, time limit) and
+// one SearchWorker per thread holding all per-thread state.
 class Search {
 public:
     // Constructor
@@ -23,62 +47,118 @@ public:
 
     /**
      * @brief The main entry point to begin a search.
-     * This will be expanded later to handle time management and iterative deepening.
-     * For now, it performs a simple fixed-depth search.
+     * Runs iterative deepening on every search thread (Lazy SMP) until the time
+     * runs out, the depth limit is reached or stopSearch is set.
      * @param board The starting position for the search.
-     * @param depth The fixed depth to search to.
+     * @param depth The maximum depth to search to.
      * @return The best move found for the current position.
      */
     chess::Move start_search(Board& board, int depth, int movetime, int wtime, int btime, int winc, int binc);
 
+    // Number of search workers, including the calling thread. Set by the UCI "Threads" option.
+    void set_threads(size_t n);
+    size_t thread_count() const { return workers.size(); }
+
+    // Aggregated over all workers. Lock-free: each worker's counters are read
+    // with relaxed loads, so these can be called while a search is running.
+    uint64_t nodes() const;
+    uint64_t nps() const;
+    int seldepth() const;
+    int64_t elapsed_ms() const;
+    // Pawn hash table probes and hits summed over the workers. Read between searches.
+    uint64_t pawn_probes() const;
+    uint64_t pawn_hits() const;
+    // Pawn entries depend on the evaluation parameters; clear them when those change
+    void clear_pawn_tables();
+    // Forgets everything learnt in earlier searches: TT, pawn tables, killers and
+    // history. On ucinewgame, when the evaluation changes (its static evals are
+    // kept in the TT), and before a search that has to be reproducible.
+    void clear();
+    // Qsearch stand-pat evaluations, and how many of them the lazy path settled. Read between searches.
+    uint64_t qsearch_evals() const;
+    uint64_t lazy_evals() const;
+    // Tablebase probes that scored a node. Read between searches.
+    uint64_t tb_hits() const;
+    // Hardware event counts of a thread per completed iteration, and summed over
+    // the threads for the whole search. Read between searches.
+    const std::vector<DepthPerf>& perf_depths(size_t thread) const { return workers[thread]->perf_depths; }
+    PerfCounts perf_total() const;
+
     // Publicly accessible search statistics
-    uint64_t nodes_searched;
-    chess::Move killer_moves[MAX_PLY][2];
-    chess::Move pv_table[MAX_PLY][MAX_PLY];
-    int history_scores[15][64]{}; // [piece][dest_sq]
-    static int evaluate(const Board& b);
+    uint64_t nodes_searched;  // all workers, for the last search
+    int64_t best_score = 0;   // of the move the last search returned, for its side to move
+    // Pawn terms come from pawns when given (a worker's pawn table), else are computed
+    static int evaluate(const Board& b, PawnTable* pawns = nullptr);
+    // Material and PSTs only, as kept by Board; the cheap part of evaluate
+    static int lazy_evaluate(const Board& b);
     TranspositionTable TT;
+    // Set by the timer thread at the deadline or by UCI "stop". Hot loops read it relaxed.
     std::atomic<bool> stopSearch;
-    ThreadPool pool;
-    std::chrono::steady_clock::time_point searchEndTime; 
+    std::chrono::steady_clock::time_point searchStartTime;
+    std::chrono::steady_clock::time_point searchEndTime;
+    bool qsearch_checks = true; // search quiet checks at the first qsearch ply
+    // Qsearch stands pat on lazy_evaluate when it is this far outside the window; 0 turns it off
+    int lazy_eval_margin = LAZY_EVAL_MARGIN;
+    // Count hardware events (utils/perf_counters.h) per iteration and thread, and
+    // report them in "info string perf" lines. Set by the UCI "PerfCounters" option.
+    bool perf_counters = false;
+    // Print nothing, for benchmarks and tests that only want the result and statistics
+    bool quiet = false;
+
+    // Public so benchmarks can drive qsearch directly
+    /**
+     * @brief Quiescence search to stabilize the evaluation at horizon nodes.
+     * Searches captures and promotions that do not lose material (SEE >= 0), plus
+     * quiet checks when quiet_checks is set, to avoid the horizon effect.
+     * @param worker The thread searching; worker.board is the current board state.
+     * @param alpha The lower bound for the score.
+     * @param beta The upper bound for the score.
+     * @param quiet_checks Also search quiet checking moves (first qsearch ply only).
+     * @return The stabilized evaluation of the position.
+     */
+    int64_t search_captures_only(SearchWorker& worker, int ply, int64_t alpha, int64_t beta, bool quiet_checks);
 
 private:
     /**
      * @brief The core Negamax search function with Alpha-Beta pruning.
-     * @param board The current board state.
+     * @param worker The thread searching; worker.board is the current board state.
      * @param depth Remaining depth to search.
      * @param alpha The lower bound for the score (best score for maximizing player).
      * @param beta The upper bound for the score (best score for minimizing player).
      * @return The evaluation of the position from the side-to-move's perspective.
      */
-    int64_t negamax(Board& board, int depth, int ply, int64_t alpha, int64_t beta);
+    int64_t negamax(SearchWorker& worker, int depth, int ply, int64_t alpha, int64_t beta);
 
     /**
-     * @brief Quiescence search to stabilize the evaluation at horizon nodes.
-     * This search only considers "non-quiet" moves like captures to avoid the horizon effect.
-     * @param board The current board state.
-     * @param alpha The lower bound for the score.
-     * @param beta The upper bound for the score.
-     * @return The stabilized evaluation of the position.
+     * @brief Iterative deepening with aspiration windows for one thread.
+     * Helper workers skip some depths so that workers spread over different depths.
+     * @param worker The thread searching.
+     * @param max_depth The deepest iteration to run.
      */
-    int64_t search_captures_only(Board& board, int ply, int64_t alpha, int64_t betas);
+    void iterative_deepening(SearchWorker& worker, int max_depth);
 
-    /**
-     * @brief Evaluates the board from the perspective of the side to move.
-     * Initially, this will be a simple material count.
-     * @param board The board state to evaluate.
-     * @return The score in centipawns. Positive is good for the current player.
-     */
+    // Watchdog that sets stopSearch at searchEndTime, so the search never reads the clock
+    void start_timer();
+    void stop_timer();
+
+    std::thread timer;
+    std::mutex timer_mutex;
+    std::condition_variable timer_cv;
+    bool timer_done = false;
+
+    // workers[0] is driven by the caller of start_search, the rest by the pool
+    std::vector<std::unique_ptr<SearchWorker>> workers;
+    std::unique_ptr<ThreadPool> pool;
 
-    inline void update_killers(int ply, const chess::Move& move) {
-        if (killer_moves[ply][0].m != move.m) {
-            killer_moves[ply][1] = killer_moves[ply][0];
-            killer_moves[ply][0] = move;
+    inline void update_killers(SearchWorker& worker, int ply, const chess::Move& move) {
+        if (worker.killer_moves[ply][0].m != move.m) {
+            worker.killer_moves[ply][1] = worker.killer_moves[ply][0];
+            worker.killer_moves[ply][0] = move;
         }
     }
 
-    inline void update_history(const Board& B, const chess::Move& move, int depth) {
-        history_scores[B.board_array[move.from()]][move.to()] += depth*depth;  //depth * depth since we want cutoffs near the root
+    inline void update_history(SearchWorker& worker, const chess::Move& move, int depth) {
+        worker.history_scores[worker.board.board_array[move.from()]][move.to()] += depth*depth;  //depth * depth since we want cutoffs near the root
     }
 
 };
\ No newline at end of file
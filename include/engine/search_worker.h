@@ -0,0 +1,91 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "chess/board.h"
+#include "chess/types.h"
+#include "pawn_table.h"
+#include "utils/perf_counters.h"
+
+#define MAX_PLY 64
+
+// One ply of a worker's search stack
+struct SearchStackEntry {
+    chess::Move pv[MAX_PLY];   // principal variation from this ply
+    int pv_length = 0;
+};
+
+// Hardware events counted during one iteration
+struct DepthPerf {
+    int depth;
+    PerfCounts counts;
+};
+
+// Everything a search thread writes during a search. Each Lazy SMP thread owns
+// one, so threads share nothing but the transposition table and the stop flag.
+// Workers are cache-line aligned so that no two threads ever write to the same
+// line; the counters the controller polls sit on a line of their own.
+struct alignas(64) SearchWorker {
+    int id = 0;
+    Board board;
+
+    // Move ordering heuristics
+    chess::Move killer_moves[MAX_PLY][2]{};
+    int history_scores[15][64]{}; // [piece][dest_sq]
+
+    SearchStackEntry stack[MAX_PLY + 1];
+
+    // Kept across searches: pawn structures repeat from move to move
+    PawnTable pawn_table;
+
+    // Qsearch stand-pat evaluations and those settled by the lazy eval; plain, like the pawn table's
+    uint64_t qsearch_evals = 0;
+    uint64_t lazy_evals = 0;
+    uint64_t tb_hits = 0;
+
+    // Filled when Search::perf_counters is set: each completed iteration, and the whole search
+    std::vector<DepthPerf> perf_depths;
+    PerfCounts perf_total;
+
+    // Result of the last fully completed iteration, read by the controller after the search
+    int completed_depth = 0;
+    int64_t best_score = 0;
+    chess::Move best_move{};
+
+    // Written only by the owning thread; the controller reads them (relaxed) for reporting
+    alignas(64) std::atomic<uint64_t> nodes{0};
+    std::atomic<int> seldepth{0};
+
+    // Prepares the worker for a new search from the given position
+    void reset(const Board& root) {
+        board = root;
+        nodes.store(0, std::memory_order_relaxed);
+        seldepth.store(0, std::memory_order_relaxed);
+        completed_depth = 0;
+        best_score = 0;
+        best_move = {};
+        stack[0].pv_length = 0;
+        pawn_table.probes = pawn_table.hits = 0;
+        qsearch_evals = lazy_evals = tb_hits = 0;
+        perf_depths.clear();
+        perf_total = {};
+    }
+
+    // No read-modify-write needed: only this thread writes its counters
+    inline void count_node() { nodes.store(nodes.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); }
+
+    inline void update_seldepth(int ply) {
+        if (ply > seldepth.load(std::memory_order_relaxed)) seldepth.store(ply, std::memory_order_relaxed);
+    }
+
+    // The PV at ply becomes move followed by the PV of the child
+    inline void update_pv(int ply, const chess::Move& move) {
+        SearchStackEntry& ss = stack[ply];
+        const SearchStackEntry& child = stack[ply + 1];
+        ss.pv[0] = move;
+        for (int i = 0; i < child.pv_length && i + 1 < MAX_PLY; ++i) ss.pv[i + 1] = child.pv[i];
+        ss.pv_length = std::min(child.pv_length + 1, MAX_PLY);
+    }
+};
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "chess/board.h"
+#include "chess/types.h"
+
+/**
+ * @file tablebase.h
+ * @brief Endgame tablebases for the 3- and 4-man material configurations.
+ *
+ * Tables are built by retrograde analysis (generate) and stored as two files per
+ * material configuration, named after it with white the side listed first ("KQKR"):
+ *   <name>.dtm  one byte per position: plies to mate, even when the side to move
+ *               is mated, odd when it mates; DTM_DRAW otherwise
+ *   <name>.wdl  two bits per position (four per byte, low bits first):
+ *               0 draw, 1 side to move loses, 2 side to move wins
+ * Both start with a 16-byte header: uint32 magic 'HCTB', uint32 version,
+ * uint32 file kind (0 dtm, 1 wdl), uint32 number of positions.
+ *
+ * Positions are indexed by side to move and the squares of the white king, the
+ * black king and the other pieces in the order of the name, 6 bits each. The
+ * board symmetries fold the white king into a1-d1-d4 (files a-d with pawns).
+ * Castling rights and en-passant captures are not indexed, so positions with
+ * them are not probed; the generator still plays the captures after a double
+ * step. The 50-move rule is ignored.
+ */
+namespace tb {
+
+constexpr uint32_t MAGIC = 0x42544348; // "HCTB"
+constexpr uint32_t VERSION = 2; // 2: KPKP plays en-passant captures
+constexpr int MAX_PIECES = 4;
+constexpr uint8_t DTM_DRAW = 255;
+
+enum WDL : int8_t { WDL_LOSS = -1, WDL_DRAW = 0, WDL_WIN = 1 };
+
+// Result of a DTM probe, for the side to move
+struct Probe {
+    WDL wdl = WDL_DRAW;
+    int plies = 0; // to mate (0 when mated), 0 for draws
+};
+
+// A material configuration and, once loaded, its mapped files
+struct Table {
+    std::string name;                  // "KQKR"
+    std::vector<chess::Piece> pieces;  // the pieces besides the kings, white's first
+    bool pawns = false;
+    uint64_t key = 0;                  // material_key of the configuration
+    uint64_t size = 0;                 // number of positions, both sides to move
+    const uint8_t* dtm = nullptr;      // mapped data, past the header
+    const uint8_t* wdl = nullptr;
+};
+
+/**
+ * @brief Maps every table in dir. Tables loaded before are released first.
+ * Returns false, with error set, when dir cannot be read.
+ */
+bool load(const std::string& dir, std::string& error);
+void unload();
+
+// Piece count of the largest loaded table, 0 when none are loaded
+extern int loaded_pieces;
+inline int max_pieces() { return loaded_pieces; }
+size_t tables_loaded();
+
+// Both return false when the position is not covered by a loaded table
+bool probe_wdl(const Board& b, WDL& result);
+bool probe_dtm(const Board& b, Probe& result);
+
+/**
+ * @brief Picks the root move that keeps the best DTM result: the fastest mate
+ * when winning, the slowest when losing. result is for the side to move.
+ */
+bool probe_root(Board& b, chess::Move& move, Probe& result);
+
+// ----------------- Indexing (shared with the generator) -----------------
+
+// Piece counts packed in nibbles, one per chess::Piece code
+uint64_t material_key(const Board& b);
+// Table description from its name; false when the name is not a 3- or 4-man configuration
+bool describe(const std::string& name, Table& table);
+// Every 3- to max_pieces-man configuration, each after the tables its captures and promotions lead to
+std::vector<std::string> all_tables(int max_pieces);
+
+// Squares of the white king, the black king and then table.pieces
+struct Placement {
+    chess::Square squares[MAX_PIECES];
+    bool white_to_move;
+};
+
+// Index of the canonical placement among its symmetric images
+uint64_t index_of(const Table& table, const Placement& p);
+// Inverse of index_of; the placement may be illegal (overlapping pieces, pawns on the back ranks)
+Placement placement_of(const Table& table, uint64_t index);
+// b's placement in table, its colours swapped when the table has them the other
+// way round; false when b has different material
+bool placement_in(const Table& table, const Board& b, Placement& p);
+// The loaded table covering b, with b's placement in it
+const Table* find(const Board& b, Placement& p);
+// Maps one table's files from dir
+bool load_table(const std::string& dir, const std::string& name, std::string& error);
+
+struct GenerateStats {
+    uint64_t positions = 0, wins = 0, draws = 0, losses = 0; // legal positions, for the side to move
+    int max_plies = 0;                                       // longest forced mate
+    double seconds = 0;
+};
+
+/**
+ * @brief Generates the table called name into dir with threads threads and loads
+ * it. The tables its captures and promotions lead to must be loaded already
+ * (all_tables lists them in a working order).
+ */
+bool generate(const std::string& name, const std::string& dir, size_t threads, GenerateStats& stats, std::string& error);
+
+} // namespace tb
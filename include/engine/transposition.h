@@ -1,14 +1,12 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include "chess/board.h"
 #include "chess/types.h"
-#include <memory>
-#include <vector>
-#include <mutex>
 
-// This is the structure for a single entry in the Transposition Table.
+// Unpacked view of a table entry, used by the search for probing and storing.
 struct TTEntry {
     enum Bound : uint8_t {
         EXACT,
@@ -16,34 +14,63 @@ struct TTEntry {
         UPPER_BOUND
     };
 
+    static constexpr int16_t NO_EVAL = INT16_MIN;
+
     uint64_t key;
     uint8_t depth;
     int64_t score;
     Bound bound;
     chess::Move best_move;
+    int16_t eval = NO_EVAL;   // static evaluation, if the storing node computed one
 };
 
 
+// Lock-free transposition table.
+//
+// Each slot is two 64-bit words: `data` packs move(16) | score(16) | eval(16) |
+// depth(8) | bound(2) + generation(6), and `key` holds zobrist_key ^ data. Both
+// words are read and written with relaxed atomics. A torn read (key from one
+// store, data from another) fails the XOR check and is treated as a miss, so
+// no locks are needed. Four slots make a 64-byte, cache-line aligned cluster.
 class TranspositionTable {
 private:
-    std::unique_ptr<TTEntry[]> table;
-    size_t num_entries;
-    
-    // We use a vector of mutexes instead of a single one to reduce lock contention.
-    // This allows different threads to write to different parts of the table simultaneously.
-    std::vector<std::mutex> locks;
-    static const size_t NumLocks = 256; // A power of 2 is common for easy hashing
+    struct Slot {
+        std::atomic<uint64_t> key;
+        std::atomic<uint64_t> data;
+    };
+
+    static constexpr int ClusterSize = 4;
+
+    struct alignas(64) Cluster {
+        Slot slots[ClusterSize];
+    };
+
+    std::unique_ptr<Cluster[]> table;
+    size_t num_clusters;
+    uint8_t generation = 0;   // 6 bits, bumped once per search
+
+    // Multiply-shift range reduction: maps the key onto [0, num_clusters)
+    // without a division.
+    inline Cluster& cluster_for(uint64_t key) const {
+        return table[(size_t)(((unsigned __int128)key * num_clusters) >> 64)];
+    }
 
 public:
-    // Constructor initializes the table and locks.
+    // Constructor allocates size_mb megabytes of clusters and clears them.
     TranspositionTable(size_t size_mb);
 
-    // Clears the table of all entries.
+    // Clears the table of all entries, using every hardware thread. Only needed
+    // on ucinewgame: between moves the table is kept and aged with new_search().
     void clear();
 
-    // Stores a new entry in the table, handling potential collisions.
+    // Starts a new search: entries from older searches become preferred victims.
+    void new_search();
+
+    // Stores a new entry. Replaces the slot holding the same position, unless that
+    // entry is from this search and more than 4 plies deeper; or else the slot
+    // with the lowest depth, older generations counting as shallower.
     void store(const TTEntry& entry);
-    
+
     // Probes the table for an existing entry with the given key.
-    bool probe(uint64_t key, TTEntry& entry);
-};
\ No newline at end of file
+    bool probe(uint64_t key, TTEntry& entry) const;
+};
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "chess/board.h"
+#include "engine/evaluate.h"
+#include "engine/search.h"
+#include "utils/threadpool.h"
+
+// Texel tuning of the classic evaluation: find the EvalData that best predicts
+// game results from evaluations, error = mean (result - sigmoid(eval))^2.
+namespace tuner {
+
+// A labelled position in the binary dataset format. Fixed-size records keep
+// datasets small and let them be streamed without parsing text.
+struct PackedPosition {
+    uint8_t squares[32]; // chess::Piece per square, two per byte, even squares in the low nibble
+    uint8_t flags;       // bit 0 white to move, bits 1-4 castling rights
+    uint8_t ep;          // en-passant square or chess::SQUARE_NONE
+    uint8_t halfmove;
+    uint8_t result;      // white's score in half points: 0 loss, 1 draw, 2 win
+};
+static_assert(sizeof(PackedPosition) == 36, "packed positions are 36 bytes on disk");
+
+PackedPosition pack(const Board& b, double result);
+// Sets up b from p and returns white's score (0, 0.5 or 1)
+double unpack(const PackedPosition& p, Board& b);
+
+// Text datasets hold one position per line: a FEN (only the first four fields
+// are read) followed by the result as "1-0", "0-1", "1/2-1/2" or [1.0] / [0.5] / [0.0].
+bool parse_result(const std::string& line, double& result);
+std::string fen_of_line(const std::string& line);
+
+// Converts a text dataset to the packed format; lines without a result are skipped
+bool pack_dataset(const std::string& in_path, const std::string& out_path, size_t& count, std::string& error);
+
+// A batch of positions read from a dataset: text lines or packed records
+struct Chunk {
+    std::vector<std::string> lines;
+    std::vector<double> results; // of lines
+    std::vector<PackedPosition> packed;
+
+    size_t size() const { return lines.size() + packed.size(); }
+    void clear() { lines.clear(); results.clear(); packed.clear(); }
+    // Sets up b from position i and returns its result
+    double load(size_t i, Board& b) const;
+};
+
+// Streams a dataset chunk by chunk, so datasets need not fit in memory
+class DatasetReader {
+public:
+    bool open(const std::string& path, std::string& error);
+    void rewind();
+    // Reads up to max positions; false once the dataset is exhausted
+    bool next(Chunk& chunk, size_t max);
+    bool packed() const { return is_packed; }
+
+private:
+    std::ifstream in;
+    bool is_packed = false;
+    std::streampos data_start = 0;
+};
+
+struct Options {
+    std::string dataset;
+    size_t threads = 1;
+    bool qsearch = false;       // score the qsearch value rather than the static eval
+    size_t chunk_size = 1 << 16;
+};
+
+class Tuner {
+public:
+    explicit Tuner(const Options& options);
+    bool open(std::string& error);
+
+    // Mean squared error of the active parameters over the dataset, for scaling constant k
+    double error(double k);
+    // The k that minimises the error for the active parameters
+    double fit_k();
+    // One round of local search over the named fields of params (all when empty):
+    // every value is moved by +-1 and the move kept when the error drops.
+    // params ends up active. Returns the number of values changed.
+    size_t local_search(eval::EvalData& params, const std::vector<std::string>& fields, double k, double& best_error);
+
+    size_t positions() const { return counted; }
+
+private:
+    double slice_error(const Chunk& chunk, size_t begin, size_t end, SearchWorker& worker, double k);
+
+    Options options;
+    DatasetReader reader;
+    ThreadPool pool;
+    std::vector<std::unique_ptr<SearchWorker>> workers; // one per slice
+    Search search; // TT and stop flag for the qsearch
+    size_t counted = 0;
+};
+
+} // namespace tuner
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Reference cycles from the time-stamp counter, where the CPU has one (0
+// elsewhere). The TSC ticks at a fixed rate, so under turbo or power saving
+// these are not core clock cycles; compare them between runs on one machine.
+inline uint64_t read_tsc() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
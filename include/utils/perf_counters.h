@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Hardware events counted around a search
+enum PerfEvent {
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_L1D_MISSES,    // L1 data cache read misses
+    PERF_LLC_MISSES,    // last-level cache misses
+    PERF_BRANCH_MISSES,
+    PERF_DTLB_MISSES,   // data TLB read misses
+    PERF_EVENT_NB
+};
+
+extern const char* const PERF_EVENT_NAMES[PERF_EVENT_NB];
+
+// Event counts; bit e of available is set when event e was counted
+struct PerfCounts {
+    uint64_t values[PERF_EVENT_NB] = {};
+    uint32_t available = 0;
+
+    bool has(PerfEvent e) const { return available >> e & 1; }
+    double ipc() const;
+
+    PerfCounts& operator+=(const PerfCounts& other);
+    PerfCounts operator-(const PerfCounts& other) const;
+
+    // "cycles 123 instructions 456 ipc 3.71 ...", the counted events only
+    std::string format() const;
+    // {"cycles": 123, ...}, the counted events only
+    std::string to_json() const;
+};
+
+// Counts the events of the calling thread, user space only, from construction
+// until destruction, with Linux perf_event_open. Each event has its own counter;
+// when the PMU has fewer counters than events the kernel multiplexes them and
+// read() scales the counts up by the time each was actually counting. Events the
+// kernel refuses (no PMU in a VM, perf_event_paranoid > 2) are left out, and on
+// other systems nothing is counted.
+class PerfCounters {
+private:
+    int fds[PERF_EVENT_NB];
+    std::string open_error;
+
+public:
+    PerfCounters();
+    ~PerfCounters();
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool available() const;
+    // Why nothing is counted, when available() is false
+    const std::string& error() const { return open_error; }
+    // Counts since construction
+    PerfCounts read() const;
+};
@@ -390,6 +390,7 @@ void init_leaper_attacks() {
 
 uint64_t Between[chess::SQUARE_NB][chess::SQUARE_NB];
 uint64_t Rays[chess::SQUARE_NB][chess::SQUARE_NB];
+uint64_t Line[chess::SQUARE_NB][chess::SQUARE_NB];
 
 void generate_between_and_ray_tables() noexcept {
     // Initialize all tables to 0ULL (empty bitboard)
@@ -397,6 +398,7 @@ void generate_between_and_ray_tables() noexcept {
         for (int s2 = 0; s2 < 64; ++s2) {
             Between[s1][s2] = 0ULL;
             Rays[s1][s2] = 0ULL;
+            Line[s1][s2] = 0ULL;
         }
     }
 
@@ -443,6 +445,16 @@ void generate_between_and_ray_tables() noexcept {
             
             // The RAY includes the squares between AND the destination square s2
             Rays[s1][s2] = between_mask | (1ULL << s2);
+
+            // The LINE extends the ray past both ends up to the board edges
+            uint64_t line_mask = Rays[s1][s2] | (1ULL << s1);
+            for (int r = s1_rank - dr, f = s1_file - df; r >= 0 && r < 8 && f >= 0 && f < 8; r -= dr, f -= df) {
+                line_mask |= (1ULL << (r * 8 + f));
+            }
+            for (int r = s2_rank + dr, f = s2_file + df; r >= 0 && r < 8 && f >= 0 && f < 8; r += dr, f += df) {
+                line_mask |= (1ULL << (r * 8 + f));
+            }
+            Line[s1][s2] = line_mask;
         }
     }
 }
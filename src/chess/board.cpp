@@ -9,6 +9,8 @@
 
 // ----------------- Constructor -----------------
 Board::Board() {
+    // Reserve once so make_move never reallocates during a search
+    undo_stack.reserve(chess::MAX_GAME_MOVES);
     clear();
 }
 
@@ -28,8 +30,12 @@ void Board::clear() {
     white_king_sq = black_king_sq = chess::SQUARE_NONE;
     zobrist_key = zobrist_pawn_key = 0;
     material_white = material_black = 0;
+    game_phase = 0;
+    psq_score = {0, 0};
     white_occupied = black_occupied = occupied = 0;
     undo_stack.clear();
+    accumulators.clear();
+    if (nnue::enabled()) accumulators.emplace_back();
 }
 
 // ----------------- FEN parsing -----------------
@@ -89,11 +95,25 @@ void Board::set_fen(std::string &fen_cstr) {
     }
 
     fullmove_number = fullmove;
+    finish_setup();
+}
+
+void Board::finish_setup() {
     update_king_squares_from_bitboards();
     update_occupancies();
-    update_game_phase();
+    refresh_scores();
     compute_pins_and_checks();
     zobrist_key = Zobrist::calculate_zobrist_hash(*this);
+    zobrist_pawn_key = Zobrist::calculate_pawn_hash(*this);
+}
+
+void Board::refresh_scores() {
+    material_white = material_black = 0;
+    game_phase = 0;
+    psq_score = {0, 0};
+    for (int sq = 0; sq < 64; ++sq) {
+        if (board_array[sq] != chess::NO_PIECE) add_piece_score(board_array[sq], (chess::Square)sq);
+    }
 }
 
 // ----------------- FEN serialization -----------------
@@ -225,7 +245,33 @@ void Board::make_move(const chess::Move &mv) {
     undo.pinned = pinned;
     undo.double_check = double_check;
     undo.zobrist_before = zobrist_key;
+    undo.pawn_key_before = zobrist_pawn_key;
     undo.game_phase = game_phase;
+    undo.material_white = material_white;
+    undo.material_black = material_black;
+    undo.psq_score = psq_score;
+
+    // A null move only passes the turn (used by null-move pruning)
+    if (mv.is_null()) {
+        if (en_passant_sq != chess::SQUARE_NONE && Zobrist::en_passant_capturable(*this)) {
+            zobrist_key ^= Zobrist::enPassantFile[en_passant_sq % 8];
+        }
+        en_passant_sq = chess::SQUARE_NONE;
+        halfmove_clock++;
+        if (!white_to_move) fullmove_number++;
+        white_to_move = !white_to_move;
+        zobrist_key ^= Zobrist::sideToMove;
+        compute_pins_and_checks();
+        verify_zobrist_key();
+        if (nnue::enabled()) accumulators.emplace_back();
+        undo_stack.push_back(undo);
+        return;
+    }
+
+    // The old ep file is only part of the key if it was capturable before the move
+    if (en_passant_sq != chess::SQUARE_NONE && Zobrist::en_passant_capturable(*this)) {
+        zobrist_key ^= Zobrist::enPassantFile[en_passant_sq % 8];
+    }
 
     // 2. Extract move details
     const chess::Square from = (chess::Square)mv.from();
@@ -234,7 +280,7 @@ void Board::make_move(const chess::Move &mv) {
     
     const chess::Piece moving_piece = (chess::Piece)board_array[from];  //remove the moved piece
 
-    zobrist_key ^= Zobrist::piecesArray[moving_piece][from];
+    zobrist_key ^= Zobrist::pieceKeys[moving_piece][from];
 
     chess::Piece captured_piece = (flags & chess::FLAG_EP) 
         ? (white_to_move ? chess::BP : chess::WP)
@@ -242,11 +288,27 @@ void Board::make_move(const chess::Move &mv) {
 
     if(captured_piece != chess::NO_PIECE){ 
         if(flags & chess::FLAG_EP){
-            zobrist_key ^= Zobrist::piecesArray[captured_piece][white_to_move ? to - 8 : to + 8];  //remove captured piece
+            zobrist_key ^= Zobrist::pieceKeys[captured_piece][white_to_move ? to - 8 : to + 8];  //remove captured piece
         }
-        else zobrist_key ^= Zobrist::piecesArray[captured_piece][to];  //remove captured piece
+        else zobrist_key ^= Zobrist::pieceKeys[captured_piece][to];  //remove captured piece
+    }
+    zobrist_key ^= Zobrist::pieceKeys[moving_piece][to];  //add the moved piece
+
+    // Running material/phase/PST sums
+    remove_piece_score(moving_piece, from);
+    add_piece_score((flags & chess::FLAG_PROMO) ? (chess::Piece)mv.promo() : moving_piece, to);
+    if (captured_piece != chess::NO_PIECE) {
+        remove_piece_score(captured_piece, (flags & chess::FLAG_EP) ? (chess::Square)(white_to_move ? to - 8 : to + 8) : to);
+    }
+
+    // Pawn key: a pawn leaves from, lands on to unless it promotes, and captured pawns vanish
+    if (chess::type_of(moving_piece) == chess::PAWN) {
+        zobrist_pawn_key ^= Zobrist::pieceKeys[moving_piece][from];
+        if (!(flags & chess::FLAG_PROMO)) zobrist_pawn_key ^= Zobrist::pieceKeys[moving_piece][to];
+    }
+    if (chess::type_of(captured_piece) == chess::PAWN) {
+        zobrist_pawn_key ^= Zobrist::pieceKeys[captured_piece][(flags & chess::FLAG_EP) ? (white_to_move ? to - 8 : to + 8) : to];
     }
-    zobrist_key ^= Zobrist::piecesArray[moving_piece][to];  //add the moved piece
 
     // Reset halfmove clock if it's a pawn move or capture
     if (chess::type_of(moving_piece) == chess::PAWN || captured_piece != chess::NO_PIECE) {
@@ -284,8 +346,8 @@ void Board::make_move(const chess::Move &mv) {
         util::set_bit(bitboard[promo_piece], to);
         board_array[to] = promo_piece;
 
-        zobrist_key ^= Zobrist::piecesArray[moving_piece][to]; //since the pawn is no longer at the destination square
-        zobrist_key ^= Zobrist::piecesArray[promo_piece][to];
+        zobrist_key ^= Zobrist::pieceKeys[moving_piece][to]; //since the pawn is no longer at the destination square
+        zobrist_key ^= Zobrist::pieceKeys[promo_piece][to];
     }
     else if (flags == chess::FLAG_EP) {
         move_piece_bb(moving_piece, from, to);
@@ -300,10 +362,12 @@ void Board::make_move(const chess::Move &mv) {
         else if (to == chess::C1) { rook_from = chess::A1; rook_to = chess::D1; }
         else if (to == chess::G8) { rook_from = chess::H8; rook_to = chess::F8; }
         else /* (to == C8) */ { rook_from = chess::A8; rook_to = chess::D8; }
+        remove_piece_score(board_array[rook_from], rook_from);
+        add_piece_score(board_array[rook_from], rook_to);
         move_piece_bb((chess::Piece)board_array[rook_from], rook_from, rook_to);
 
-        zobrist_key ^= Zobrist::piecesArray[chess::make_piece(white_to_move ? chess::WHITE : chess::BLACK,chess::ROOK)][rook_from];
-        zobrist_key ^= Zobrist::piecesArray[chess::make_piece(white_to_move ? chess::WHITE : chess::BLACK,chess::ROOK)][rook_to];
+        zobrist_key ^= Zobrist::pieceKeys[chess::make_piece(white_to_move ? chess::WHITE : chess::BLACK,chess::ROOK)][rook_from];
+        zobrist_key ^= Zobrist::pieceKeys[chess::make_piece(white_to_move ? chess::WHITE : chess::BLACK,chess::ROOK)][rook_to];
     }
     // Handle pawn double push to set en passant square
     else if (flags == chess::FLAG_DOUBLE_PUSH) {
@@ -331,16 +395,8 @@ void Board::make_move(const chess::Move &mv) {
         castle_rights &= chess::CastlingRights(~chess::BLACK_KINGSIDE);
     }
 
-    zobrist_key ^= Zobrist::castlingRights[undo.prev_castle_rights];
-    zobrist_key ^= Zobrist::castlingRights[castle_rights];
-    
-    if(undo.prev_en_passant_sq != chess::SQUARE_NONE)
-    {
-       zobrist_key ^= Zobrist::enPassantFile[undo.prev_en_passant_sq];
-    }
-    if (en_passant_sq != chess::SQUARE_NONE) {
-        zobrist_key ^= Zobrist::enPassantFile[en_passant_sq];
-    }
+    zobrist_key ^= Zobrist::castlingKeys[undo.prev_castle_rights];
+    zobrist_key ^= Zobrist::castlingKeys[castle_rights];
     
     // 5. Update king square if it moved
     if (moving_piece == chess::WK) white_king_sq = to;
@@ -352,16 +408,64 @@ void Board::make_move(const chess::Move &mv) {
 
     zobrist_key ^= Zobrist::sideToMove; //Always flip this
 
+    // New ep file only counts if the side now to move can actually take
+    if (en_passant_sq != chess::SQUARE_NONE && Zobrist::en_passant_capturable(*this)) {
+        zobrist_key ^= Zobrist::enPassantFile[en_passant_sq % 8];
+    }
+
     // 7. Update combined bitboards
     update_occupancies();
-    update_game_phase();
     compute_pins_and_checks();
-    zobrist_key = Zobrist::calculate_zobrist_hash(*this);
+    verify_zobrist_key();
 
     // 8. Push state to undo stack
+    if (nnue::enabled()) push_accumulator(mv, moving_piece, captured_piece);
     undo_stack.push_back(undo);
 }
 
+void Board::push_accumulator(const chess::Move& mv, chess::Piece moving_piece, chess::Piece captured_piece) {
+    nnue::Accumulator& acc = accumulators.emplace_back();
+    nnue::DirtyPiece& dirty = acc.dirty;
+    const chess::Square from = (chess::Square)mv.from();
+    const chess::Square to = (chess::Square)mv.to();
+    const uint16_t flags = mv.flags();
+
+    dirty.sub(moving_piece, from);
+    dirty.add((flags & chess::FLAG_PROMO) ? (chess::Piece)mv.promo() : moving_piece, to);
+    if (captured_piece != chess::NO_PIECE) {
+        // Side to move has already flipped: the mover is !white_to_move
+        const chess::Square captured_sq = (flags == chess::FLAG_EP) ? (chess::Square)(white_to_move ? to + 8 : to - 8) : to;
+        dirty.sub(captured_piece, captured_sq);
+    }
+    if (flags == chess::FLAG_CASTLE) {
+        const chess::Piece rook = chess::make_piece(chess::color_of(moving_piece), chess::ROOK);
+        const bool kingside = (to == chess::G1 || to == chess::G8);
+        const chess::Square rank_base = (chess::Square)(to & 56);
+        dirty.sub(rook, (chess::Square)(rank_base + (kingside ? 7 : 0)));
+        dirty.add(rook, (chess::Square)(rank_base + (kingside ? 5 : 3)));
+    }
+    if (chess::type_of(moving_piece) == chess::KING) dirty.refresh[chess::color_of(moving_piece)] = true;
+}
+
+
+void Board::verify_zobrist_key() const {
+#ifdef VERIFY_ZOBRIST
+    const uint64_t full_key = Zobrist::calculate_zobrist_hash(*this);
+    if (zobrist_key != full_key) {
+        std::ostringstream msg;
+        msg << "Incremental zobrist key 0x" << std::hex << zobrist_key
+            << " differs from full hash 0x" << full_key << std::dec << " in " << to_fen();
+        throw std::logic_error(msg.str());
+    }
+    const uint64_t full_pawn_key = Zobrist::calculate_pawn_hash(*this);
+    if (zobrist_pawn_key != full_pawn_key) {
+        std::ostringstream msg;
+        msg << "Incremental pawn key 0x" << std::hex << zobrist_pawn_key
+            << " differs from full pawn hash 0x" << full_pawn_key << std::dec << " in " << to_fen();
+        throw std::logic_error(msg.str());
+    }
+#endif
+}
 
 //-----------------------------------------------------------------------------
 // UNMAKE MOVE
@@ -385,12 +489,21 @@ void Board::unmake_move(const chess::Move &mv) {
     pinned = undo.pinned;
     double_check = undo.double_check;
     zobrist_key = undo.zobrist_before;
+    zobrist_pawn_key = undo.pawn_key_before;
     game_phase = undo.game_phase;
+    material_white = undo.material_white;
+    material_black = undo.material_black;
+    psq_score = undo.psq_score;
 
     // Switch side back
     white_to_move = !white_to_move;
     if (!white_to_move) fullmove_number--;
 
+    if (accumulators.size() > undo_stack.size() + 1) accumulators.pop_back();
+
+    // Null move touched no pieces
+    if (mv.is_null()) return;
+
     chess::Piece moving_piece = (chess::Piece)board_array[to];
     const chess::Piece captured_piece = (chess::Piece)(undo.captured_piece_and_halfmove & 0xF);
 
@@ -448,6 +561,10 @@ void Board::unmake_move(const chess::Move &mv) {
 }
 
 bool Board::square_attacked(chess::Square sq, bool by_white) const{
+    return square_attacked(sq, by_white, occupied);
+}
+
+bool Board::square_attacked(chess::Square sq, bool by_white, uint64_t occupancy) const{
     
     chess::Color attackerColor = (by_white) ? chess::WHITE : chess::BLACK;
     // 1. Pawns
@@ -463,10 +580,10 @@ bool Board::square_attacked(chess::Square sq, bool by_white) const{
     uint64_t diagonal_pieces = bitboard[chess::make_piece(attackerColor, chess::BISHOP)] | bitboard[chess::make_piece(attackerColor, chess::QUEEN)];
 
     // 4. Orthogonal Sliders
-    if (chess::get_orthogonal_slider_attacks(sq, occupied) & orthogonal_pieces) return true;
+    if (chess::get_orthogonal_slider_attacks(sq, occupancy) & orthogonal_pieces) return true;
 
     // 5. Diagnol Sliders
-    if (chess::get_diagonal_slider_attacks(sq, occupied) & diagonal_pieces) return true;
+    if (chess::get_diagonal_slider_attacks(sq, occupancy) & diagonal_pieces) return true;
 
     return false;
 }
@@ -65,4 +65,91 @@ void Board::compute_pins_and_checks() {
     if (util::count_bits(checks) > 1) {
         double_check = true;
     }
-}
\ No newline at end of file
+}
+
+CheckInfo Board::compute_check_info() const {
+    CheckInfo ci;
+
+    const chess::Color color = white_to_move ? chess::WHITE : chess::BLACK;
+    const chess::Color oppColor = white_to_move ? chess::BLACK : chess::WHITE;
+    const chess::Square king_sq = white_to_move ? black_king_sq : white_king_sq;
+    const uint64_t friendly_bitboard = white_to_move ? white_occupied : black_occupied;
+
+    ci.enemy_king_sq = king_sq;
+    ci.check_squares[chess::NO_PIECE_TYPE] = 0ULL;
+    ci.check_squares[chess::PAWN] = chess::PawnAttacks[oppColor][king_sq];
+    ci.check_squares[chess::KNIGHT] = chess::KnightAttacks[king_sq];
+    ci.check_squares[chess::BISHOP] = chess::get_diagonal_slider_attacks(king_sq, occupied);
+    ci.check_squares[chess::ROOK] = chess::get_orthogonal_slider_attacks(king_sq, occupied);
+    ci.check_squares[chess::QUEEN] = ci.check_squares[chess::BISHOP] | ci.check_squares[chess::ROOK];
+    ci.check_squares[chess::KING] = 0ULL;
+
+    // Same x-ray as the pin detection above, but from the enemy king towards our sliders
+    const uint64_t our_queens = bitboard[chess::make_piece(color, chess::QUEEN)];
+    uint64_t sliders = ((bitboard[chess::make_piece(color, chess::ROOK)] | our_queens) & chess::get_orthogonal_slider_attacks(king_sq, 0))
+                     | ((bitboard[chess::make_piece(color, chess::BISHOP)] | our_queens) & chess::get_diagonal_slider_attacks(king_sq, 0));
+
+    ci.discoverers = 0ULL;
+    while (sliders) {
+        const chess::Square slider_sq = util::pop_lsb(sliders);
+        const uint64_t pieces_on_line = chess::Between[king_sq][slider_sq] & occupied;
+        if (util::count_bits(pieces_on_line) == 1 && (pieces_on_line & friendly_bitboard)) {
+            ci.discoverers |= pieces_on_line;
+        }
+    }
+
+    return ci;
+}
+
+bool Board::gives_check(const chess::Move& move, const CheckInfo& ci) const {
+    const chess::Square from = (chess::Square)move.from();
+    const chess::Square to = (chess::Square)move.to();
+    const uint16_t flags = move.flags();
+    const uint64_t from_bb = ONE << from;
+    const uint64_t to_bb = ONE << to;
+    const uint64_t king_bb = ONE << ci.enemy_king_sq;
+    const chess::Color color = white_to_move ? chess::WHITE : chess::BLACK;
+
+    // Direct check. A promoted piece attacks with the pawn already gone from its square.
+    if (flags & chess::FLAG_PROMO) {
+        const uint64_t occ = (occupied ^ from_bb) | to_bb;
+        switch (chess::type_of((chess::Piece)move.promo())) {
+            case chess::KNIGHT: if (chess::KnightAttacks[to] & king_bb) return true; break;
+            case chess::BISHOP: if (chess::get_diagonal_slider_attacks(to, occ) & king_bb) return true; break;
+            case chess::ROOK:   if (chess::get_orthogonal_slider_attacks(to, occ) & king_bb) return true; break;
+            case chess::QUEEN:
+                if ((chess::get_diagonal_slider_attacks(to, occ) | chess::get_orthogonal_slider_attacks(to, occ)) & king_bb) return true;
+                break;
+            default: break;
+        }
+    } else if (ci.check_squares[chess::type_of(board_array[from])] & to_bb) {
+        return true;
+    }
+
+    // Discovered check: a blocker leaves the line to the king
+    if ((ci.discoverers & from_bb) && !(chess::Line[from][ci.enemy_king_sq] & to_bb)) {
+        return true;
+    }
+
+    // En passant also removes the captured pawn, which may uncover a slider
+    if (flags & chess::FLAG_EP) {
+        const chess::Square captured_sq = white_to_move ? (chess::Square)(to - 8) : (chess::Square)(to + 8);
+        const uint64_t occ = (occupied ^ from_bb ^ (ONE << captured_sq)) | to_bb;
+        const uint64_t queens = bitboard[chess::make_piece(color, chess::QUEEN)];
+        const uint64_t rooks_queens = bitboard[chess::make_piece(color, chess::ROOK)] | queens;
+        const uint64_t bishops_queens = bitboard[chess::make_piece(color, chess::BISHOP)] | queens;
+        return (chess::get_orthogonal_slider_attacks(ci.enemy_king_sq, occ) & rooks_queens)
+             | (chess::get_diagonal_slider_attacks(ci.enemy_king_sq, occ) & bishops_queens);
+    }
+
+    // Castling can only check with the rook
+    if (flags & chess::FLAG_CASTLE) {
+        const bool kingside = to > from;
+        const chess::Square rook_from = (chess::Square)(kingside ? from + 3 : from - 4);
+        const chess::Square rook_to = (chess::Square)(kingside ? from + 1 : from - 1);
+        const uint64_t occ = (occupied ^ from_bb ^ (ONE << rook_from)) | to_bb | (ONE << rook_to);
+        return chess::get_orthogonal_slider_attacks(rook_to, occ) & king_bb;
+    }
+
+    return false;
+}
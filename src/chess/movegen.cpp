@@ -1,14 +1,42 @@
 #include "chess/movegen.h"
 
-void MoveGen::init(const Board& B, std::vector<chess::Move>& moveList, bool capturesOnly){
+void MoveGen::init(const Board& B, chess::MoveList& moveList, GenType type, bool legalOnly){
     if(B.double_check){
-        generate_king_moves(B, moveList, capturesOnly);
+        generate_king_moves(B, moveList, type, legalOnly);
         return;
     }
 
-    generate_pawn_moves(B, moveList, capturesOnly);
-    generate_knight_moves(B, moveList, capturesOnly);
-    generate_orthogonal_sliders_moves(B, moveList, capturesOnly);
-    generate_diagonal_sliders_moves(B, moveList, capturesOnly);
-    generate_king_moves(B, moveList, capturesOnly);
-}
\ No newline at end of file
+    generate_pawn_moves(B, moveList, type, legalOnly);
+    generate_knight_moves(B, moveList, type, legalOnly);
+    generate_orthogonal_sliders_moves(B, moveList, type, legalOnly);
+    generate_diagonal_sliders_moves(B, moveList, type, legalOnly);
+    generate_king_moves(B, moveList, type, legalOnly);
+}
+
+bool MoveGen::is_legal(const Board& B, chess::Move move){
+    if(move.is_null()) return false;
+
+    const chess::Piece piece = B.board_array[move.from()];
+    const chess::Color us = B.white_to_move ? chess::WHITE : chess::BLACK;
+    if(piece == chess::NO_PIECE || chess::color_of(piece) != us) return false;
+    if(B.double_check && chess::type_of(piece) != chess::KING) return false;
+
+    chess::MoveList moveList;
+    switch(chess::type_of(piece)){
+        case chess::PAWN:   generate_pawn_moves(B, moveList, ALL, true); break;
+        case chess::KNIGHT: generate_knight_moves(B, moveList, ALL, true); break;
+        case chess::BISHOP: generate_diagonal_sliders_moves(B, moveList, ALL, true); break;
+        case chess::ROOK:   generate_orthogonal_sliders_moves(B, moveList, ALL, true); break;
+        case chess::QUEEN:
+            generate_orthogonal_sliders_moves(B, moveList, ALL, true);
+            generate_diagonal_sliders_moves(B, moveList, ALL, true);
+            break;
+        case chess::KING:   generate_king_moves(B, moveList, ALL, true); break;
+        default: return false;
+    }
+
+    for(const auto& m : moveList){
+        if(m.m == move.m) return true;
+    }
+    return false;
+}
@@ -0,0 +1,99 @@
+#include "chess/movegen.h"
+
+// Quiet checks for quiescence search. Non-king pieces land on a check square of
+// their own type, or are discoverers leaving the line to the enemy king.
+// Promotions are not quiet here, they come from the CAPTURES generator.
+
+static uint64_t piece_attacks(chess::PieceType pt, chess::Square sq, uint64_t occupied)
+{
+    switch (pt)
+    {
+        case chess::KNIGHT: return chess::KnightAttacks[sq];
+        case chess::BISHOP: return chess::get_diagonal_slider_attacks(sq, occupied);
+        case chess::ROOK:   return chess::get_orthogonal_slider_attacks(sq, occupied);
+        case chess::QUEEN:  return chess::get_diagonal_slider_attacks(sq, occupied) | chess::get_orthogonal_slider_attacks(sq, occupied);
+        default:            return 0ULL;
+    }
+}
+
+// Destinations of the piece on from that give check
+static inline uint64_t checking_targets(const CheckInfo& ci, chess::PieceType pt, chess::Square from)
+{
+    if (ci.discoverers & util::create_bitboard_from_square(from))
+        return ~chess::Line[from][ci.enemy_king_sq] | ci.check_squares[pt];
+    return ci.check_squares[pt];
+}
+
+static void generate_pawn_quiet_checks(const Board& B, chess::MoveList& moveList, const CheckInfo& ci, uint64_t target)
+{
+    const uint64_t our_pawns = B.white_to_move ? B.bitboard[chess::WP] : B.bitboard[chess::BP];
+    const uint64_t empty_squares = ~B.occupied;
+    const chess::Direction push_dir = B.white_to_move ? chess::NORTH : chess::SOUTH;
+    const chess::Direction pull_dir = B.white_to_move ? chess::SOUTH : chess::NORTH;
+
+    const uint64_t pawns_to_push = B.white_to_move ? (our_pawns & ~util::Rank7) : (our_pawns & ~util::Rank2);
+    const uint64_t double_push_rank = B.white_to_move ? util::Rank3 : util::Rank6;
+
+    const uint64_t single = util::shift_board(pawns_to_push, push_dir) & empty_squares;
+    uint64_t doubles = util::shift_board(single & double_push_rank, push_dir) & empty_squares & target;
+    uint64_t singles = single & target;
+
+    while (singles)
+    {
+        const chess::Square to = util::pop_lsb(singles);
+        const chess::Square from = util::shift_square(to, pull_dir);
+        const uint64_t to_bb = util::create_bitboard_from_square(to);
+        if (!(checking_targets(ci, chess::PAWN, from) & to_bb)) continue;
+        if (!(MoveGen::pin_mask(B, from, true) & to_bb)) continue;
+        moveList.push_back(chess::Move(from, to, chess::FLAG_QUIET, chess::NO_PIECE));
+    }
+
+    while (doubles)
+    {
+        const chess::Square to = util::pop_lsb(doubles);
+        const chess::Square from = util::shift_square(util::shift_square(to, pull_dir), pull_dir);
+        const uint64_t to_bb = util::create_bitboard_from_square(to);
+        if (!(checking_targets(ci, chess::PAWN, from) & to_bb)) continue;
+        if (!(MoveGen::pin_mask(B, from, true) & to_bb)) continue;
+        moveList.push_back(chess::Move(from, to, chess::FLAG_DOUBLE_PUSH, chess::NO_PIECE));
+    }
+}
+
+void MoveGen::generate_quiet_checks(const Board& B, chess::MoveList& moveList, const CheckInfo& ci)
+{
+    const chess::Color color = B.white_to_move ? chess::WHITE : chess::BLACK;
+
+    if (!B.double_check)
+    {
+        const uint64_t target = ~B.occupied & evasion_mask(B, true);
+
+        generate_pawn_quiet_checks(B, moveList, ci, target);
+
+        for (const chess::PieceType pt : {chess::KNIGHT, chess::BISHOP, chess::ROOK, chess::QUEEN})
+        {
+            uint64_t pieces = B.bitboard[chess::make_piece(color, pt)];
+            while (pieces)
+            {
+                const chess::Square from = util::pop_lsb(pieces);
+                uint64_t attacks = piece_attacks(pt, from, B.occupied) & target & checking_targets(ci, pt, from) & pin_mask(B, from, true);
+                while (attacks)
+                {
+                    moveList.push_back(chess::Move(from, util::pop_lsb(attacks), chess::FLAG_QUIET, chess::NO_PIECE));
+                }
+            }
+        }
+    }
+
+    // The king only checks by discovery or through the rook when castling
+    const chess::Square king_sq = B.white_to_move ? B.white_king_sq : B.black_king_sq;
+    const bool can_castle = B.castle_rights & (B.white_to_move ? chess::WHITE_CASTLING : chess::BLACK_CASTLING);
+    if ((ci.discoverers & util::create_bitboard_from_square(king_sq)) || can_castle)
+    {
+        chess::MoveList kingMoves;
+        generate_king_moves(B, kingMoves, QUIETS, true);
+        for (const auto& m : kingMoves)
+        {
+            if (B.gives_check(m, ci)) moveList.push_back(m);
+        }
+    }
+}
@@ -1,35 +1,37 @@
 #include "chess/movegen.h"
 
-void generate_king_moves_no_castle(const Board& B, std::vector<chess::Move>& moveList, bool capturesOnly){
+void generate_king_moves_no_castle(const Board& B, chess::MoveList& moveList, MoveGen::GenType type, bool legalOnly){
     const chess::Color color = B.white_to_move ? chess::WHITE : chess::BLACK;
     uint64_t kingBitboard = B.bitboard[chess::make_piece(color, chess::KING)];
+    // Take the king off the board so sliders checking it also cover the squares behind it
+    const uint64_t occupancy = legalOnly ? (B.occupied ^ kingBitboard) : B.occupied;
     while (kingBitboard){
         const chess::Square currKingSquare = util::pop_lsb(kingBitboard);
         uint64_t attacks = chess::KingAttacks[currKingSquare];
         uint64_t quietMoves = attacks & (~B.occupied);
 
-        if(!capturesOnly)
+        if(type != MoveGen::CAPTURES)
         {
             while (quietMoves){
                 const chess::Square destinationKingSquare = util::pop_lsb(quietMoves);
-                if (B.square_attacked(destinationKingSquare, color)) continue;
+                if (B.square_attacked(destinationKingSquare, color, occupancy)) continue;
                 chess::Move m(currKingSquare, destinationKingSquare, chess::FLAG_QUIET, chess::NO_PIECE);
                 moveList.push_back(m);
             }
         }
 
-        uint64_t captures = (attacks & (color ? B.white_occupied : B.black_occupied));
+        uint64_t captures = (type != MoveGen::QUIETS) ? (attacks & (color ? B.white_occupied : B.black_occupied)) : 0ULL;
 
         while (captures){
             const chess::Square destinationKingSquare = util::pop_lsb(captures);
-            if (B.square_attacked(destinationKingSquare, color)) continue;
+            if (B.square_attacked(destinationKingSquare, color, occupancy)) continue;
             chess::Move m(currKingSquare, destinationKingSquare, chess::FLAG_CAPTURE, chess::NO_PIECE);
             moveList.push_back(m);
         }
     }
 }
 
-void generate_king_moves_castle(const Board& B, std::vector<chess::Move>& moveList) {
+void generate_king_moves_castle(const Board& B, chess::MoveList& moveList) {
     const chess::Color color = B.white_to_move ? chess::WHITE : chess::BLACK;
 
     const chess::Square king_start_sq = (color == chess::WHITE) ? chess::E1 : chess::E8;
@@ -64,7 +66,7 @@ void generate_king_moves_castle(const Board& B, std::vector<chess::Move>& moveLi
     }
 }
 
-void MoveGen::generate_king_moves(const Board& B, std::vector<chess::Move>& moveList, bool capturesOnly){
-    generate_king_moves_no_castle(B,moveList,capturesOnly);
-    if(!capturesOnly) generate_king_moves_castle(B,moveList);
+void MoveGen::generate_king_moves(const Board& B, chess::MoveList& moveList, GenType type, bool legalOnly){
+    generate_king_moves_no_castle(B,moveList,type,legalOnly);
+    if(type != CAPTURES) generate_king_moves_castle(B,moveList);
 }
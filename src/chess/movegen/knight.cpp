@@ -1,17 +1,17 @@
 #include "chess/movegen.h"
 
-void MoveGen::generate_knight_moves(const Board& B, std::vector<chess::Move>& moveList, bool capturesOnly){
+void MoveGen::generate_knight_moves(const Board& B, chess::MoveList& moveList, GenType type, bool legalOnly){
     const chess::Color color = B.white_to_move ? chess::WHITE : chess::BLACK;
+    const uint64_t target = evasion_mask(B, legalOnly);
     uint64_t knightBitboard = B.bitboard[chess::make_piece(color, chess::KNIGHT)];
     while (knightBitboard){
         const chess::Square currKnightSquare = util::pop_lsb(knightBitboard);
-        uint64_t attacks = chess::KnightAttacks[currKnightSquare] & ~(color ? B.black_occupied : B.white_occupied);
+        uint64_t attacks = chess::KnightAttacks[currKnightSquare] & gen_mask(B, type) & target & pin_mask(B, currKnightSquare, legalOnly);
 
         while (attacks){
             const chess::Square destinationKnightSquare = util::pop_lsb(attacks);
             const chess::MoveFlag flag = (util::create_bitboard_from_square(destinationKnightSquare) & (color ? B.white_occupied : B.black_occupied)) ? chess::FLAG_CAPTURE : chess::FLAG_QUIET; 
 
-            if(capturesOnly && flag == chess::FLAG_QUIET) continue;
 
             chess::Move m(currKnightSquare, destinationKnightSquare, flag, chess::NO_PIECE);
             moveList.push_back(m);
@@ -1,8 +1,8 @@
 #include "chess/movegen.h"
 
-void add_pawn_promotion_moves(const Board& B, const chess::Square currSq, const chess::Square dstSq, const chess::MoveFlag flags, std::vector<chess::Move>& moveList)
+void add_pawn_promotion_moves(const Board& B, const chess::Square currSq, const chess::Square dstSq, const chess::MoveFlag flags, chess::MoveList& moveList)
 {
-    const std::vector<chess::PieceType> pieces = {chess::KNIGHT, chess::BISHOP, chess::ROOK, chess::QUEEN};
+    constexpr chess::PieceType pieces[] = {chess::KNIGHT, chess::BISHOP, chess::ROOK, chess::QUEEN};
     const chess::Color color = B.white_to_move ? chess::WHITE : chess::BLACK;
 
     for (const auto piece : pieces)
@@ -12,7 +12,39 @@ void add_pawn_promotion_moves(const Board& B, const chess::Square currSq, const
     }
 }
 
-void generate_pawn_single_push(const Board& B, std::vector<chess::Move>& moveList)
+// A pinned pawn may only move along its pin ray
+inline bool pin_allows(const Board& B, const chess::Square from, const chess::Square to, bool legalOnly)
+{
+    return MoveGen::pin_mask(B, from, legalOnly) & util::create_bitboard_from_square(to);
+}
+
+// En passant removes two pawns from the same rank at once, so the pin mask and
+// check mask are not enough (e.g. king and rook on the 5th rank with both pawns
+// between them). Replay the capture on the occupancy and look for attackers.
+bool ep_capture_is_legal(const Board& B, const chess::Square from)
+{
+    const chess::Color us = B.white_to_move ? chess::WHITE : chess::BLACK;
+    const chess::Color them = B.white_to_move ? chess::BLACK : chess::WHITE;
+    const chess::Square king_sq = B.white_to_move ? B.white_king_sq : B.black_king_sq;
+    const chess::Square to = B.en_passant_sq;
+    const chess::Square captured_sq = B.white_to_move ? (chess::Square)(to - 8) : (chess::Square)(to + 8);
+
+    const uint64_t occupancy = (B.occupied ^ util::create_bitboard_from_square(from) ^ util::create_bitboard_from_square(captured_sq))
+                             | util::create_bitboard_from_square(to);
+
+    const uint64_t their_rooks_queens = B.bitboard[chess::make_piece(them, chess::ROOK)] | B.bitboard[chess::make_piece(them, chess::QUEEN)];
+    const uint64_t their_bishops_queens = B.bitboard[chess::make_piece(them, chess::BISHOP)] | B.bitboard[chess::make_piece(them, chess::QUEEN)];
+    const uint64_t their_pawns = B.bitboard[chess::make_piece(them, chess::PAWN)] & ~util::create_bitboard_from_square(captured_sq);
+
+    if (chess::get_orthogonal_slider_attacks(king_sq, occupancy) & their_rooks_queens) return false;
+    if (chess::get_diagonal_slider_attacks(king_sq, occupancy) & their_bishops_queens) return false;
+    if (chess::KnightAttacks[king_sq] & B.bitboard[chess::make_piece(them, chess::KNIGHT)]) return false;
+    if (chess::PawnAttacks[us][king_sq] & their_pawns) return false;
+
+    return true;
+}
+
+void generate_pawn_single_push(const Board& B, chess::MoveList& moveList, bool legalOnly)
 {
     const uint64_t our_pawns = B.white_to_move ? B.bitboard[chess::WP] : B.bitboard[chess::BP];
     const uint64_t empty_squares = ~B.occupied;
@@ -21,17 +53,18 @@ void generate_pawn_single_push(const Board& B, std::vector<chess::Move>& moveLis
 
     const uint64_t pawns_to_push = B.white_to_move ? (our_pawns & ~util::Rank7) : (our_pawns & ~util::Rank2);
 
-    uint64_t destinations = util::shift_board(pawns_to_push, push_dir) & empty_squares;
+    uint64_t destinations = util::shift_board(pawns_to_push, push_dir) & empty_squares & MoveGen::evasion_mask(B, legalOnly);
 
     while (destinations)
     {
         const chess::Square to = util::pop_lsb(destinations);
         const chess::Square from = util::shift_square(to, pull_dir);
+        if (!pin_allows(B, from, to, legalOnly)) continue;
         moveList.push_back(chess::Move(from, to, chess::FLAG_QUIET, chess::NO_PIECE));
     }
 }
 
-void generate_push_double_push(const Board& B, std::vector<chess::Move>& moveList)
+void generate_push_double_push(const Board& B, chess::MoveList& moveList, bool legalOnly)
 {
     const uint64_t our_pawns = B.white_to_move ? B.bitboard[chess::WP] : B.bitboard[chess::BP];
     const uint64_t empty_squares = ~B.occupied;
@@ -41,17 +74,18 @@ void generate_push_double_push(const Board& B, std::vector<chess::Move>& moveLis
     const uint64_t pawns_on_start_rank = B.white_to_move ? (our_pawns & util::Rank2) : (our_pawns & util::Rank7);
 
     const uint64_t pushes1 = util::shift_board(pawns_on_start_rank, push_dir) & empty_squares;
-    uint64_t destinations = util::shift_board(pushes1, push_dir) & empty_squares;
+    uint64_t destinations = util::shift_board(pushes1, push_dir) & empty_squares & MoveGen::evasion_mask(B, legalOnly);
 
     while (destinations)
     {
         const chess::Square to = util::pop_lsb(destinations);
         const chess::Square from = util::shift_square(util::shift_square(to, pull_dir), pull_dir);
+        if (!pin_allows(B, from, to, legalOnly)) continue;
         moveList.push_back(chess::Move(from, to, chess::FLAG_DOUBLE_PUSH, chess::NO_PIECE));
     }
 }
 
-void generate_pawn_captures(const Board& B, std::vector<chess::Move>& moveList)
+void generate_pawn_captures(const Board& B, chess::MoveList& moveList, bool legalOnly)
 {
     const uint64_t our_pawns = B.white_to_move ? B.bitboard[chess::WP] : B.bitboard[chess::BP];
     const uint64_t opponent_pieces = B.white_to_move ? B.black_occupied
@@ -62,28 +96,30 @@ void generate_pawn_captures(const Board& B, std::vector<chess::Move>& moveList)
 
     const chess::Direction dir1 = B.white_to_move ? chess::NORTH_WEST : chess::SOUTH_WEST;
     const chess::Direction pull_dir1 = B.white_to_move ? chess::SOUTH_EAST : chess::NORTH_EAST;
-    uint64_t captures1 = util::shift_board(pawns_to_capture, dir1) & opponent_pieces;
+    uint64_t captures1 = util::shift_board(pawns_to_capture, dir1) & opponent_pieces & MoveGen::evasion_mask(B, legalOnly);
 
     while (captures1)
     {
         const chess::Square to = util::pop_lsb(captures1);
         const chess::Square from = util::shift_square(to, pull_dir1);
+        if (!pin_allows(B, from, to, legalOnly)) continue;
         moveList.push_back(chess::Move(from, to, chess::FLAG_CAPTURE, chess::NO_PIECE));
     }
 
     const chess::Direction dir2 = B.white_to_move ? chess::NORTH_EAST : chess::SOUTH_EAST;
     const chess::Direction pull_dir2 = B.white_to_move ? chess::SOUTH_WEST : chess::NORTH_WEST;
-    uint64_t captures2 = util::shift_board(pawns_to_capture, dir2) & opponent_pieces;
+    uint64_t captures2 = util::shift_board(pawns_to_capture, dir2) & opponent_pieces & MoveGen::evasion_mask(B, legalOnly);
 
     while (captures2)
     {
         const chess::Square to = util::pop_lsb(captures2);
         const chess::Square from = util::shift_square(to, pull_dir2);
+        if (!pin_allows(B, from, to, legalOnly)) continue;
         moveList.push_back(chess::Move(from, to, chess::FLAG_CAPTURE, chess::NO_PIECE));
     }
 }
 
-void generate_pawn_promotion(const Board& B, std::vector<chess::Move>& moveList)
+void generate_pawn_promotion(const Board& B, chess::MoveList& moveList, bool legalOnly)
 {
     const uint64_t our_pawns = B.white_to_move ? B.bitboard[chess::WP] : B.bitboard[chess::BP];
     const uint64_t empty_squares = ~B.occupied;
@@ -92,17 +128,18 @@ void generate_pawn_promotion(const Board& B, std::vector<chess::Move>& moveList)
 
     const uint64_t promoting_pawns = B.white_to_move ? (our_pawns & util::Rank7) : (our_pawns & util::Rank2);
 
-    uint64_t destinations = util::shift_board(promoting_pawns, push_dir) & empty_squares;
+    uint64_t destinations = util::shift_board(promoting_pawns, push_dir) & empty_squares & MoveGen::evasion_mask(B, legalOnly);
 
     while (destinations)
     {
         const chess::Square to = util::pop_lsb(destinations);
         const chess::Square from = util::shift_square(to, pull_dir);
+        if (!pin_allows(B, from, to, legalOnly)) continue;
         add_pawn_promotion_moves(B, from, to, chess::FLAG_PROMO, moveList);
     }
 }
 
-void generate_pawn_ep_captures(const Board& B, std::vector<chess::Move>& moveList)
+void generate_pawn_ep_captures(const Board& B, chess::MoveList& moveList, bool legalOnly)
 {
     if (B.en_passant_sq == chess::SQUARE_NONE) return;
 
@@ -116,11 +153,12 @@ void generate_pawn_ep_captures(const Board& B, std::vector<chess::Move>& moveLis
     while (attacking_pawns)
     {
         const chess::Square from = util::pop_lsb(attacking_pawns);
+        if (legalOnly && !ep_capture_is_legal(B, from)) continue;
         moveList.push_back(chess::Move(from, B.en_passant_sq, chess::FLAG_EP, chess::NO_PIECE));
     }
 }
 
-void generate_pawn_promotion_captures(const Board& B, std::vector<chess::Move>& moveList)
+void generate_pawn_promotion_captures(const Board& B, chess::MoveList& moveList, bool legalOnly)
 {
     const uint64_t our_pawns = B.white_to_move ? B.bitboard[chess::WP] : B.bitboard[chess::BP];
     const uint64_t opponent_pieces = B.white_to_move ? B.black_occupied
@@ -131,37 +169,42 @@ void generate_pawn_promotion_captures(const Board& B, std::vector<chess::Move>&
 
     const chess::Direction dir1 = B.white_to_move ? chess::NORTH_WEST : chess::SOUTH_WEST;
     const chess::Direction pull_dir1 = B.white_to_move ? chess::SOUTH_EAST : chess::NORTH_EAST;
-    uint64_t captures1 = util::shift_board(promoting_pawns, dir1) & opponent_pieces;
+    uint64_t captures1 = util::shift_board(promoting_pawns, dir1) & opponent_pieces & MoveGen::evasion_mask(B, legalOnly);
 
     while (captures1)
     {
         const chess::Square to = util::pop_lsb(captures1);
         const chess::Square from = util::shift_square(to, pull_dir1);
+        if (!pin_allows(B, from, to, legalOnly)) continue;
         add_pawn_promotion_moves(B, from, to, chess::FLAG_CAPTURE_PROMO, moveList);
     }
 
     const chess::Direction dir2 = B.white_to_move ? chess::NORTH_EAST : chess::SOUTH_EAST;
     const chess::Direction pull_dir2 = B.white_to_move ? chess::SOUTH_WEST : chess::NORTH_WEST;
-    uint64_t captures2 = util::shift_board(promoting_pawns, dir2) & opponent_pieces;
+    uint64_t captures2 = util::shift_board(promoting_pawns, dir2) & opponent_pieces & MoveGen::evasion_mask(B, legalOnly);
 
     while (captures2)
     {
         const chess::Square to = util::pop_lsb(captures2);
         const chess::Square from = util::shift_square(to, pull_dir2);
+        if (!pin_allows(B, from, to, legalOnly)) continue;
         add_pawn_promotion_moves(B, from, to, chess::FLAG_CAPTURE_PROMO, moveList);
     }
 }
 
-void MoveGen::generate_pawn_moves(const Board& B, std::vector<chess::Move>& moveList, bool capturesOnly)
+void MoveGen::generate_pawn_moves(const Board& B, chess::MoveList& moveList, GenType type, bool legalOnly)
 {
-    generate_pawn_captures(B, moveList);
-    generate_pawn_ep_captures(B, moveList);
-    generate_pawn_promotion_captures(B, moveList);
+    if(type != QUIETS)
+    {
+        generate_pawn_captures(B, moveList, legalOnly);
+        generate_pawn_ep_captures(B, moveList, legalOnly);
+        generate_pawn_promotion_captures(B, moveList, legalOnly);
+        generate_pawn_promotion(B, moveList, legalOnly);
+    }
 
-    if(!capturesOnly)
+    if(type != CAPTURES)
     {
-        generate_pawn_single_push(B, moveList);
-        generate_push_double_push(B, moveList);
-        generate_pawn_promotion(B, moveList);
+        generate_pawn_single_push(B, moveList, legalOnly);
+        generate_push_double_push(B, moveList, legalOnly);
     }
 }
\ No newline at end of file
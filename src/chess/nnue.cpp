@@ -0,0 +1,253 @@
+#include "chess/nnue.h"
+#include "chess/board.h"
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define NNUE_X86
+#endif
+
+namespace nnue {
+
+bool use_nnue = false;
+
+namespace {
+
+struct Network {
+    std::vector<int16_t> feature_biases;   // [L1]
+    std::vector<int16_t> feature_weights;  // [INPUTS][L1]
+    std::vector<int16_t> output_weights;   // [2 * L1]
+    int32_t output_bias = 0;
+};
+
+std::unique_ptr<Network> net;
+
+// ----------------- Kernels -----------------
+// dst = src + sum(add rows) - sum(sub rows); dst may alias src
+using AddSubFn = void (*)(int16_t* dst, const int16_t* src, const int16_t* const* add, int n_add, const int16_t* const* sub, int n_sub);
+// Clipped ReLU of both accumulators dotted with the output weights
+using ForwardFn = int32_t (*)(const int16_t* us, const int16_t* them, const int16_t* weights);
+
+void add_sub_scalar(int16_t* dst, const int16_t* src, const int16_t* const* add, int n_add, const int16_t* const* sub, int n_sub) {
+    for (int i = 0; i < L1; ++i) {
+        int16_t v = src[i];
+        for (int a = 0; a < n_add; ++a) v += add[a][i];
+        for (int s = 0; s < n_sub; ++s) v -= sub[s][i];
+        dst[i] = v;
+    }
+}
+
+int32_t forward_scalar(const int16_t* us, const int16_t* them, const int16_t* weights) {
+    int32_t sum = 0;
+    for (int i = 0; i < L1; ++i) {
+        sum += std::clamp<int32_t>(us[i], 0, QA) * weights[i];
+        sum += std::clamp<int32_t>(them[i], 0, QA) * weights[L1 + i];
+    }
+    return sum;
+}
+
+#ifdef NNUE_X86
+__attribute__((target("sse4.1")))
+void add_sub_sse41(int16_t* dst, const int16_t* src, const int16_t* const* add, int n_add, const int16_t* const* sub, int n_sub) {
+    for (int i = 0; i < L1; i += 8) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        for (int a = 0; a < n_add; ++a) v = _mm_add_epi16(v, _mm_loadu_si128((const __m128i*)(add[a] + i)));
+        for (int s = 0; s < n_sub; ++s) v = _mm_sub_epi16(v, _mm_loadu_si128((const __m128i*)(sub[s] + i)));
+        _mm_storeu_si128((__m128i*)(dst + i), v);
+    }
+}
+
+__attribute__((target("sse4.1")))
+int32_t forward_sse41(const int16_t* us, const int16_t* them, const int16_t* weights) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i qa = _mm_set1_epi16(QA);
+    __m128i sum = zero;
+    for (int i = 0; i < L1; i += 8) {
+        __m128i u = _mm_min_epi16(_mm_max_epi16(_mm_loadu_si128((const __m128i*)(us + i)), zero), qa);
+        __m128i t = _mm_min_epi16(_mm_max_epi16(_mm_loadu_si128((const __m128i*)(them + i)), zero), qa);
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(u, _mm_loadu_si128((const __m128i*)(weights + i))));
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(t, _mm_loadu_si128((const __m128i*)(weights + L1 + i))));
+    }
+    sum = _mm_hadd_epi32(sum, sum);
+    sum = _mm_hadd_epi32(sum, sum);
+    return _mm_cvtsi128_si32(sum);
+}
+
+__attribute__((target("avx2")))
+void add_sub_avx2(int16_t* dst, const int16_t* src, const int16_t* const* add, int n_add, const int16_t* const* sub, int n_sub) {
+    for (int i = 0; i < L1; i += 16) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(src + i));
+        for (int a = 0; a < n_add; ++a) v = _mm256_add_epi16(v, _mm256_loadu_si256((const __m256i*)(add[a] + i)));
+        for (int s = 0; s < n_sub; ++s) v = _mm256_sub_epi16(v, _mm256_loadu_si256((const __m256i*)(sub[s] + i)));
+        _mm256_storeu_si256((__m256i*)(dst + i), v);
+    }
+}
+
+__attribute__((target("avx2")))
+int32_t forward_avx2(const int16_t* us, const int16_t* them, const int16_t* weights) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i qa = _mm256_set1_epi16(QA);
+    __m256i sum = zero;
+    for (int i = 0; i < L1; i += 16) {
+        __m256i u = _mm256_min_epi16(_mm256_max_epi16(_mm256_loadu_si256((const __m256i*)(us + i)), zero), qa);
+        __m256i t = _mm256_min_epi16(_mm256_max_epi16(_mm256_loadu_si256((const __m256i*)(them + i)), zero), qa);
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(u, _mm256_loadu_si256((const __m256i*)(weights + i))));
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(t, _mm256_loadu_si256((const __m256i*)(weights + L1 + i))));
+    }
+    __m128i s = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    s = _mm_hadd_epi32(s, s);
+    s = _mm_hadd_epi32(s, s);
+    return _mm_cvtsi128_si32(s);
+}
+#endif
+
+struct Kernels {
+    AddSubFn add_sub;
+    ForwardFn forward;
+    const char* name;
+};
+
+Kernels pick_kernels() {
+#ifdef NNUE_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return {add_sub_avx2, forward_avx2, "avx2"};
+    if (__builtin_cpu_supports("sse4.1")) return {add_sub_sse41, forward_sse41, "sse4.1"};
+#endif
+    return {add_sub_scalar, forward_scalar, "scalar"};
+}
+
+const Kernels kernels = pick_kernels();
+
+// ----------------- Features -----------------
+inline int feature_index(chess::Color perspective, chess::Square king_sq, chess::Piece piece, chess::Square sq) {
+    int ksq = king_sq, psq = sq;
+    if (perspective == chess::BLACK) { ksq ^= 56; psq ^= 56; }
+    const int piece_idx = (chess::type_of(piece) - 1) * 2 + (chess::color_of(piece) != perspective);
+    return ksq * 641 + piece_idx * 64 + psq + 1;
+}
+
+inline const int16_t* feature_row(int index) {
+    return net->feature_weights.data() + (size_t)index * L1;
+}
+
+void refresh(const Board& b, Accumulator& acc, chess::Color perspective) {
+    const chess::Square king_sq = (perspective == chess::WHITE) ? b.white_king_sq : b.black_king_sq;
+    kernels.add_sub(acc.values[perspective], net->feature_biases.data(), nullptr, 0, nullptr, 0);
+
+    // Add the rows a few at a time so each pass stays in registers
+    const int16_t* rows[8];
+    int n = 0;
+    for (int piece : {chess::WP, chess::WN, chess::WB, chess::WR, chess::WQ, chess::BP, chess::BN, chess::BB, chess::BR, chess::BQ}) {
+        uint64_t bb = b.bitboard[piece];
+        while (bb) {
+            rows[n++] = feature_row(feature_index(perspective, king_sq, (chess::Piece)piece, util::pop_lsb(bb)));
+            if (n == 8) {
+                kernels.add_sub(acc.values[perspective], acc.values[perspective], rows, n, nullptr, 0);
+                n = 0;
+            }
+        }
+    }
+    if (n) kernels.add_sub(acc.values[perspective], acc.values[perspective], rows, n, nullptr, 0);
+    acc.computed[perspective] = true;
+}
+
+void apply(const Accumulator& prev, Accumulator& acc, chess::Color perspective, chess::Square king_sq) {
+    const DirtyPiece& d = acc.dirty;
+    const int16_t* add[2];
+    const int16_t* sub[2];
+    int n_add = 0, n_sub = 0;
+    // King moves of the other side only move a non-feature
+    for (int i = 0; i < d.n_add; ++i) {
+        if (chess::type_of(d.add_piece[i]) != chess::KING) add[n_add++] = feature_row(feature_index(perspective, king_sq, d.add_piece[i], d.add_sq[i]));
+    }
+    for (int i = 0; i < d.n_sub; ++i) {
+        if (chess::type_of(d.sub_piece[i]) != chess::KING) sub[n_sub++] = feature_row(feature_index(perspective, king_sq, d.sub_piece[i], d.sub_sq[i]));
+    }
+    kernels.add_sub(acc.values[perspective], prev.values[perspective], add, n_add, sub, n_sub);
+    acc.computed[perspective] = true;
+}
+
+// Brings the top of the stack up to date for one perspective: walk back to the
+// last computed ply and replay the moves, or refresh if that side's king moved.
+void update(const Board& b, chess::Color perspective) {
+    auto& stack = b.accumulators;
+    const int top = (int)stack.size() - 1;
+    int j = top;
+    while (!stack[j].computed[perspective]) {
+        if (j == 0 || stack[j].dirty.refresh[perspective]) {
+            refresh(b, stack[top], perspective);
+            return;
+        }
+        --j;
+    }
+    const chess::Square king_sq = (perspective == chess::WHITE) ? b.white_king_sq : b.black_king_sq;
+    for (int k = j + 1; k <= top; ++k) apply(stack[k - 1], stack[k], perspective, king_sq);
+}
+
+template <typename T>
+bool read(std::ifstream& in, T* data, size_t count) {
+    return (bool)in.read(reinterpret_cast<char*>(data), sizeof(T) * count);
+}
+
+} // namespace
+
+bool load(const std::string& path, std::string& error) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+
+    uint32_t header[4];
+    if (!read(in, header, 4) || header[0] != MAGIC || header[1] != VERSION) {
+        error = path + " is not a version " + std::to_string(VERSION) + " network";
+        return false;
+    }
+    if (header[2] != (uint32_t)INPUTS || header[3] != (uint32_t)L1) {
+        error = path + " has an unsupported architecture";
+        return false;
+    }
+
+    auto fresh = std::make_unique<Network>();
+    fresh->feature_biases.resize(L1);
+    fresh->feature_weights.resize((size_t)INPUTS * L1);
+    fresh->output_weights.resize(2 * L1);
+    if (!read(in, fresh->feature_biases.data(), L1)
+        || !read(in, fresh->feature_weights.data(), (size_t)INPUTS * L1)
+        || !read(in, fresh->output_weights.data(), 2 * L1)
+        || !read(in, &fresh->output_bias, 1)) {
+        error = path + " is truncated";
+        return false;
+    }
+
+    net = std::move(fresh);
+    return true;
+}
+
+bool loaded() { return net != nullptr; }
+
+bool set_enabled(bool on) {
+    use_nnue = on && loaded();
+    return use_nnue == on;
+}
+
+const char* simd_name() { return kernels.name; }
+
+int evaluate(const Board& b) {
+    // Stacks fall out of step when NNUE is switched on with moves already made
+    if (b.accumulators.size() != b.undo_stack.size() + 1) {
+        b.accumulators.assign(b.undo_stack.size() + 1, Accumulator());
+    }
+    update(b, chess::WHITE);
+    update(b, chess::BLACK);
+
+    const Accumulator& acc = b.accumulators.back();
+    const chess::Color us = b.white_to_move ? chess::WHITE : chess::BLACK;
+    const int32_t out = kernels.forward(acc.values[us], acc.values[~us], net->output_weights.data()) + net->output_bias;
+    return (int)((int64_t)out * SCALE / (QA * QB));
+}
+
+} // namespace nnue
@@ -0,0 +1,205 @@
+#include "chess/perft.h"
+#include "chess/movegen.h"
+#include "utils/threadpool.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+
+uint64_t perft::count(Board& b, int depth) {
+    if (depth == 0) return 1;
+    chess::MoveList moves;
+    MoveGen::init(b, moves, MoveGen::ALL, true);
+    if (depth == 1) return moves.size();
+
+    uint64_t nodes = 0;
+    for (const auto& move : moves) {
+        b.make_move(move);
+        nodes += count(b, depth - 1);
+        b.unmake_move(move);
+    }
+    return nodes;
+}
+
+perft::Hash::Hash(size_t size_mb) {
+    num_clusters = std::max<size_t>(1, size_mb * 1024 * 1024 / sizeof(Cluster));
+    table = std::make_unique<Cluster[]>(num_clusters);
+    clear();
+}
+
+void perft::Hash::clear() {
+    for (size_t i = 0; i < num_clusters; ++i) {
+        for (Slot& slot : table[i].slots) {
+            slot.key.store(0, std::memory_order_relaxed);
+            slot.data.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+// data = nodes << 8 | depth; depth 0 is never stored, so zeroed slots never match
+bool perft::Hash::probe(uint64_t key, int depth, uint64_t& nodes) const {
+    for (const Slot& slot : cluster_for(key).slots) {
+        const uint64_t data = slot.data.load(std::memory_order_relaxed);
+        if ((slot.key.load(std::memory_order_relaxed) ^ data) == key && int(data & 0xFF) == depth) {
+            nodes = data >> 8;
+            return true;
+        }
+    }
+    return false;
+}
+
+void perft::Hash::store(uint64_t key, int depth, uint64_t nodes) {
+    Slot* victim = nullptr;
+    int victim_depth = 256;
+    for (Slot& slot : cluster_for(key).slots) {
+        const uint64_t data = slot.data.load(std::memory_order_relaxed);
+        const int slot_depth = int(data & 0xFF);
+        if ((slot.key.load(std::memory_order_relaxed) ^ data) == key && slot_depth == depth) return;
+        if (slot_depth < victim_depth) {
+            victim = &slot;
+            victim_depth = slot_depth;
+        }
+    }
+    const uint64_t data = nodes << 8 | uint64_t(depth);
+    victim->key.store(key ^ data, std::memory_order_relaxed);
+    victim->data.store(data, std::memory_order_relaxed);
+}
+
+uint64_t perft::count(Board& b, int depth, Hash& hash) {
+    if (depth <= 1) return count(b, depth);
+    uint64_t nodes = 0;
+    if (hash.probe(b.zobrist_key, depth, nodes)) return nodes;
+
+    chess::MoveList moves;
+    MoveGen::init(b, moves, MoveGen::ALL, true);
+    for (const auto& move : moves) {
+        b.make_move(move);
+        nodes += count(b, depth - 1, hash);
+        b.unmake_move(move);
+    }
+    hash.store(b.zobrist_key, depth, nodes);
+    return nodes;
+}
+
+namespace {
+
+struct Task {
+    Board board;
+    uint64_t multiplicity;
+    size_t moves;      // legal moves at the task's root, the size estimate it is ordered by
+    uint64_t nodes;
+};
+
+// Tasks shallower than this cost less than claiming them
+constexpr int MIN_TASK_DEPTH = 3;
+
+} // namespace
+
+uint64_t perft::count_parallel(const Board& b, int depth, size_t threads, Hash* hash, ParallelStats* stats) {
+    threads = std::max<size_t>(1, threads);
+    std::vector<Task> tasks;
+    tasks.push_back({b, 1, 0, 0});
+    int plies = 0;
+    size_t positions = 1;
+
+    // One ply further at a time; identical positions merge into one task
+    while (tasks.size() < threads * TASKS_PER_THREAD && depth - plies > MIN_TASK_DEPTH) {
+        std::vector<Task> next;
+        std::unordered_map<uint64_t, size_t> seen;
+        positions = 0;
+        for (Task& task : tasks) {
+            chess::MoveList moves;
+            MoveGen::init(task.board, moves, MoveGen::ALL, true);
+            for (const auto& move : moves) {
+                ++positions;
+                task.board.make_move(move);
+                auto [it, inserted] = seen.emplace(task.board.zobrist_key, next.size());
+                if (inserted) next.push_back({task.board, task.multiplicity, 0, 0});
+                else next[it->second].multiplicity += task.multiplicity;
+                task.board.unmake_move(move);
+            }
+        }
+        tasks = std::move(next);
+        ++plies;
+    }
+
+    for (Task& task : tasks) {
+        chess::MoveList moves;
+        MoveGen::init(task.board, moves, MoveGen::ALL, true);
+        task.moves = moves.size();
+    }
+    std::stable_sort(tasks.begin(), tasks.end(), [](const Task& x, const Task& y) { return x.moves > y.moves; });
+
+    std::atomic<size_t> cursor{0};
+    auto worker = [&]() {
+        for (size_t i = cursor.fetch_add(1); i < tasks.size(); i = cursor.fetch_add(1)) {
+            Board& board = tasks[i].board;
+            tasks[i].nodes = hash ? count(board, depth - plies, *hash) : count(board, depth - plies);
+        }
+    };
+    if (threads == 1) {
+        worker();
+    } else {
+        ThreadPool pool(threads);
+        std::vector<std::future<void>> futures;
+        for (size_t t = 0; t < threads; ++t) futures.push_back(pool.enqueue(worker));
+        for (auto& future : futures) future.get();
+    }
+
+    uint64_t nodes = 0;
+    for (const Task& task : tasks) nodes += task.nodes * task.multiplicity;
+    if (stats) *stats = {plies, positions, tasks.size()};
+    return nodes;
+}
+
+std::vector<perft::Division> perft::divide(Board& b, int depth) {
+    chess::MoveList moves;
+    MoveGen::init(b, moves, MoveGen::ALL, true);
+    std::vector<Division> divisions;
+    for (const auto& move : moves) {
+        b.make_move(move);
+        divisions.push_back({move, depth > 1 ? count(b, depth - 1) : 1});
+        b.unmake_move(move);
+    }
+    return divisions;
+}
+
+bool perft::load_suite(const std::string& path, std::vector<SuiteEntry>& entries, std::string& error) {
+    std::ifstream in(path);
+    if (!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+    std::string line;
+    for (int number = 1; std::getline(in, line); ++number) {
+        if (line.find_first_not_of(" \t\r") == std::string::npos || line[0] == '#') continue;
+
+        SuiteEntry entry;
+        entry.line = number;
+        std::istringstream fields(line);
+        std::getline(fields, entry.fen, ';');
+        entry.fen.erase(entry.fen.find_last_not_of(" \t") + 1);
+
+        std::string field;
+        while (std::getline(fields, field, ';')) {
+            std::istringstream parts(field);
+            std::string tag;
+            uint64_t nodes = 0;
+            if (!(parts >> tag >> nodes) || tag.size() < 2 || tag[0] != 'D' || !std::isdigit((unsigned char)tag[1])) {
+                error = path + ":" + std::to_string(number) + ": expected \"Dn <count>\", got \"" + field + "\"";
+                return false;
+            }
+            const int depth = std::stoi(tag.substr(1));
+            if (depth < 1 || depth > 20) {
+                error = path + ":" + std::to_string(number) + ": depth out of range";
+                return false;
+            }
+            if (int(entry.expected.size()) < depth) entry.expected.resize(depth, 0);
+            entry.expected[depth - 1] = nodes;
+        }
+        entries.push_back(entry);
+    }
+    return true;
+}
@@ -209,6 +209,8 @@ uint64_t Zobrist::piecesArray[12][64];
 uint64_t Zobrist::castlingRights[4];
 uint64_t Zobrist::enPassantFile[8];
 uint64_t Zobrist::sideToMove;
+uint64_t Zobrist::pieceKeys[16][64];
+uint64_t Zobrist::castlingKeys[16];
 
 
 /**
@@ -254,6 +256,43 @@ void Zobrist::init_zobrist_keys() {
     
     offset += 8; // Start at index 780
     Zobrist::sideToMove = random64[offset]; // 780
+
+    // Engine-indexed copies used by the incremental update in make_move
+    for (int p = 0; p < 16; ++p)
+        for (int sq = 0; sq < 64; ++sq)
+            Zobrist::pieceKeys[p][sq] = 0;
+
+    for (int p = chess::WP; p <= chess::BK; ++p) {
+        if (p == 7 || p == 8) continue;
+        int polyglot_index = get_polyglot_piece_index((chess::Piece)p);
+        for (int sq = 0; sq < 64; ++sq)
+            Zobrist::pieceKeys[p][sq] = Zobrist::piecesArray[polyglot_index][sq];
+    }
+
+    for (int mask = 0; mask < 16; ++mask) {
+        uint64_t key = 0;
+        if (mask & chess::WHITE_KINGSIDE)  key ^= Zobrist::castlingRights[0];
+        if (mask & chess::WHITE_QUEENSIDE) key ^= Zobrist::castlingRights[1];
+        if (mask & chess::BLACK_KINGSIDE)  key ^= Zobrist::castlingRights[2];
+        if (mask & chess::BLACK_QUEENSIDE) key ^= Zobrist::castlingRights[3];
+        Zobrist::castlingKeys[mask] = key;
+    }
+}
+
+/**
+ * @brief Polyglot only hashes the en passant file when a pawn of the side to
+ * move stands next to the double-pushed pawn, ready to capture it.
+ */
+bool Zobrist::en_passant_capturable(const Board& B)
+{
+    if (B.en_passant_sq == chess::SQUARE_NONE) return false;
+
+    // Our pawns attacking the ep square are exactly the squares an enemy pawn
+    // on the ep square would attack.
+    const chess::Color them = B.white_to_move ? chess::BLACK : chess::WHITE;
+    const uint64_t our_pawns = B.white_to_move ? B.bitboard[chess::WP] : B.bitboard[chess::BP];
+
+    return (chess::PawnAttacks[them][B.en_passant_sq] & our_pawns) != 0;
 }
 
 /**
@@ -263,9 +302,6 @@ void Zobrist::init_zobrist_keys() {
 uint64_t Zobrist::calculate_zobrist_hash(const Board& B)
 {
     uint64_t hash = 0;
-    
-    // Assuming 1ULL is defined somewhere (like board.h)
-    const uint64_t ONE = 1ULL; 
 
     // --- 1. Pieces ---
     for(int p = chess::WP; p <= chess::BK; ++p) {
@@ -280,40 +316,9 @@ uint64_t Zobrist::calculate_zobrist_hash(const Board& B)
         }
     }
 
-    // --- 2. En Passant (THE FIX) ---
-    if (B.en_passant_sq != chess::SQUARE_NONE) {
-        int ep_file = B.en_passant_sq % 8;
-        bool can_capture = false;
-        
-        // Define rank masks (assuming 0=Rank1, 7=Rank8)
-        const uint64_t RANK_4_MASK = 0xFF000000ULL;
-        const uint64_t RANK_5_MASK = 0xFF00000000ULL;
-
-        if (B.white_to_move) {
-            // White to move. EP target square is on rank 6.
-            // We check for white pawns on rank 5.
-            uint64_t white_pawns_on_rank_5 = B.bitboard[chess::WP] & RANK_5_MASK;
-            if (white_pawns_on_rank_5) {
-                // Check pawn to the left (e.g., c5 for d6)
-                if (ep_file > 0 && (white_pawns_on_rank_5 & (ONE << (B.en_passant_sq - 9)))) can_capture = true;
-                // Check pawn to the right (e.g., e5 for d6)
-                if (!can_capture && ep_file < 7 && (white_pawns_on_rank_5 & (ONE << (B.en_passant_sq - 7)))) can_capture = true;
-            }
-        } else {
-            // Black to move. EP target square is on rank 3.
-            // We check for black pawns on rank 4.
-            uint64_t black_pawns_on_rank_4 = B.bitboard[chess::BP] & RANK_4_MASK;
-            if (black_pawns_on_rank_4) {
-                // Check pawn to the left (e.g., d4 for e3)
-                if (ep_file > 0 && (black_pawns_on_rank_4 & (ONE << (B.en_passant_sq + 7)))) can_capture = true;
-                // Check pawn to the right (e.g., f4 for e3)
-                if (!can_capture && ep_file < 7 && (black_pawns_on_rank_4 & (ONE << (B.en_passant_sq + 9)))) can_capture = true;
-            }
-        }
-
-        if (can_capture) {
-            hash ^= Zobrist::enPassantFile[ep_file];
-        }
+    // --- 2. En Passant ---
+    if (Zobrist::en_passant_capturable(B)) {
+        hash ^= Zobrist::enPassantFile[B.en_passant_sq % 8];
     }
     
     // --- 3. Castling ---
@@ -328,4 +333,17 @@ uint64_t Zobrist::calculate_zobrist_hash(const Board& B)
     }
 
     return hash;
-}
\ No newline at end of file
+}
+
+uint64_t Zobrist::calculate_pawn_hash(const Board& B)
+{
+    uint64_t hash = 0;
+    for (int p : {chess::WP, chess::BP}) {
+        uint64_t bb = B.bitboard[p];
+        while(bb) {
+            int sq = util::pop_lsb(bb);
+            hash ^= Zobrist::pieceKeys[p][sq];
+        }
+    }
+    return hash;
+}
@@ -0,0 +1,138 @@
+#include "engine/evaluate.h"
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+
+namespace eval {
+
+namespace {
+
+// Storage for a set loaded at runtime; the defaults stay in read-only memory
+EvalData loaded_params = default_eval_data;
+
+const char* const piece_names[chess::PIECE_TYPE_NB] = {"none", "pawn", "knight", "bishop", "rook", "queen", "king"};
+
+template <size_t N>
+ParamField field(const std::string& name, std::array<TaperedScore, N>& scores) {
+    return {name, scores.data(), nullptr, (int)(2 * N)};
+}
+
+ParamField field(const std::string& name, TaperedScore& score) {
+    return {name, &score, nullptr, 2};
+}
+
+} // namespace
+
+const EvalData* active = &default_eval_data;
+
+void set_params(const EvalData& data) {
+    loaded_params = data;
+    active = &loaded_params;
+    fill_psqt(loaded_params);
+}
+
+void reset_params() {
+    active = &default_eval_data;
+    fill_psqt(default_eval_data);
+}
+
+std::vector<ParamField> param_fields(EvalData& data) {
+    std::vector<ParamField> fields;
+    fields.push_back(field("material_values", data.material_values));
+    for (int pt = chess::PAWN; pt <= chess::KING; ++pt) {
+        fields.push_back(field(std::string("psts.") + piece_names[pt], data.psts[pt]));
+    }
+    fields.push_back(field("bishop_pair_bonus", data.bishop_pair_bonus));
+    fields.push_back(field("rook_on_open_file_bonus", data.rook_on_open_file_bonus));
+    fields.push_back(field("rook_on_semi_open_file_bonus", data.rook_on_semi_open_file_bonus));
+    fields.push_back(field("rook_on_7th_bonus", data.rook_on_7th_bonus));
+    fields.push_back(field("knight_outpost_bonus", data.knight_outpost_bonus));
+    fields.push_back(field("bishop_center_control", data.bishop_center_control));
+    fields.push_back(field("good_bishop_bonus", data.good_bishop_bonus));
+    fields.push_back(field("controlled_square_bonus", data.controlled_square_bonus));
+    for (int pt = chess::KNIGHT; pt <= chess::QUEEN; ++pt) {
+        fields.push_back(field(std::string("mobility_bonus.") + piece_names[pt], data.mobility_bonus[pt]));
+    }
+    fields.push_back(field("doubled_pawn_penalty", data.doubled_pawn_penalty));
+    fields.push_back(field("isolated_pawn_penalty", data.isolated_pawn_penalty));
+    fields.push_back(field("backward_pawn_penalty", data.backward_pawn_penalty));
+    fields.push_back(field("pawn_chain_bonus", data.pawn_chain_bonus));
+    fields.push_back(field("passed_pawn_bonus", data.passed_pawn_bonus));
+    fields.push_back(field("passed_pawn_supported_bonus", data.passed_pawn_supported_bonus));
+    fields.push_back(field("passed_pawn_blocked_penalty", data.passed_pawn_blocked_penalty));
+    fields.push_back(field("king_distance_from_center_penalty", data.king_distance_from_center_penalty));
+    fields.push_back(field("opponent_king_distance_from_center_bonus", data.opponent_king_distance_from_center_bonus));
+    fields.push_back(field("king_distance_from_opponent_king_penalty", data.king_distance_from_opponent_king_penalty));
+    fields.push_back(field("pawn_majority_bonus", data.pawn_majority_bonus));
+    fields.push_back(field("rook_connected_bonus", data.rook_connected_bonus));
+    fields.push_back(field("pawn_shield_penalty", data.pawn_shield_penalty));
+    fields.push_back(field("open_file_penalty", data.open_file_penalty));
+    fields.push_back({"king_attack_weights", nullptr, data.king_attack_weights.data(), (int)data.king_attack_weights.size()});
+    fields.push_back(field("king_safety_table", data.king_safety_table));
+    return fields;
+}
+
+bool load_params(const std::string& path, EvalData& data, std::string& error) {
+    std::ifstream in(path);
+    if (!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+
+    // Values may wrap over several lines, so parse a token stream without the comments
+    std::stringstream tokens;
+    std::string line;
+    while (std::getline(in, line)) tokens << line.substr(0, line.find('#')) << '\n';
+
+    // Parse into a copy so that a bad file leaves data untouched
+    EvalData parsed = data;
+    std::unordered_map<std::string, ParamField> fields;
+    for (const ParamField& f : param_fields(parsed)) fields[f.name] = f;
+
+    std::string name;
+    while (tokens >> name) {
+        auto it = fields.find(name);
+        if (it == fields.end()) {
+            error = path + ": unknown parameter " + name;
+            return false;
+        }
+        const ParamField& f = it->second;
+        for (int i = 0; i < f.count; ++i) {
+            if (!(tokens >> f[i])) {
+                error = path + ": " + name + " needs " + std::to_string(f.count) + " values";
+                return false;
+            }
+        }
+    }
+
+    data = parsed;
+    return true;
+}
+
+bool save_params(const std::string& path, const EvalData& data, std::string& error) {
+    std::ofstream out(path);
+    if (!out) {
+        error = "cannot write " + path;
+        return false;
+    }
+
+    EvalData copy = data; // param_fields hands out mutable views
+    out << "# Evaluation parameters: <name> <values>, TaperedScores as mg eg pairs\n";
+    for (const ParamField& f : param_fields(copy)) {
+        out << f.name;
+        // Tables get one row of eight scores per line
+        const bool table = f.count > 16;
+        for (int i = 0; i < f.count; ++i) {
+            if (table && i % 16 == 0) out << "\n   ";
+            out << ' ' << f[i];
+        }
+        out << '\n';
+    }
+    if (!out) {
+        error = "cannot write " + path;
+        return false;
+    }
+    return true;
+}
+
+} // namespace eval
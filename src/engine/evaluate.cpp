@@ -1,652 +1,487 @@
 #include <array>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
 #include "engine/search.h"
 #include "engine/evaluate.h"
-
-eval::TaperedScore king_safety_score(const Board& b, chess::Color color) {
-    eval::TaperedScore safety_score = {0, 0};
-    chess::Square king_square = (color == chess::WHITE) ? b.white_king_sq : b.black_king_sq;
-    int king_file = util::get_file(king_square);
-
-    // --- Part 1: Pawn Shield Evaluation (Corrected) ---
-    for (int file_idx = king_file - 1; file_idx <= king_file + 1; ++file_idx) {
-        if (file_idx < 0 || file_idx > 7) {
-            continue; 
-        }
-
-        uint64_t file_mask = chess::files[file_idx];
-        uint64_t friendly_pawns = file_mask & (color == chess::WHITE ? b.bitboard[chess::WP] : b.bitboard[chess::BP]);
-
-        if (friendly_pawns == 0) {
-            safety_score.mg -= eval::eval_data.open_file_penalty.mg;
-            safety_score.eg -= eval::eval_data.open_file_penalty.eg;
-        } 
-        else {
-            chess::Square pawn_sq = (color == chess::WHITE) ? util::lsb(friendly_pawns) : util::msb(friendly_pawns);
-
-            int pawn_rank = util::get_rank(pawn_sq);
-            int ideal_rank = (color == chess::WHITE) ? util::Rank2 : util::Rank7;
-            int rank_dist = std::abs(pawn_rank - ideal_rank);
-
-            if (rank_dist > 0 && rank_dist < eval::eval_data.pawn_shield_penalty.size()) {
-                safety_score.mg -= eval::eval_data.pawn_shield_penalty[rank_dist].mg;
-                safety_score.eg -= eval::eval_data.pawn_shield_penalty[rank_dist].eg;
-            }
+#include "chess/psqt.h"
+#include "utils/cycles.h"
+
+chess::Score psqt::table[16][64];
+int32_t psqt::material[16];
+
+void eval::fill_psqt(const EvalData& data) {
+    for (int pt = chess::PAWN; pt <= chess::KING; ++pt) {
+        const chess::Piece white = chess::make_piece(chess::WHITE, (chess::PieceType)pt);
+        const chess::Piece black = chess::make_piece(chess::BLACK, (chess::PieceType)pt);
+        const eval::TaperedScore value = data.material_values[pt];
+        for (int sq = 0; sq < 64; ++sq) {
+            const eval::TaperedScore w = data.psts[pt][sq];
+            const eval::TaperedScore b = data.psts[pt][util::flip((chess::Square)sq)];
+            psqt::table[white][sq] = { int16_t(value.mg + w.mg), int16_t(value.eg + w.eg) };
+            psqt::table[black][sq] = { int16_t(-(value.mg + b.mg)), int16_t(-(value.eg + b.eg)) };
         }
+        psqt::material[white] = psqt::material[black] = (pt == chess::KING) ? 0 : value.mg;
     }
+}
 
-    // --- Part 2: Attacks on the King Zone (This part was already correct) ---
-    int attack_score = 0;
-    chess::Color enemy_color = (color == chess::WHITE) ? chess::BLACK : chess::WHITE;
-    bool by_white = (enemy_color == chess::WHITE);
-    int king_rank = util::get_rank(king_square); // king_file is already defined above
+// Fills the psqt tables from the defaults before any Board is set up
+static const bool psqt_ready = (eval::fill_psqt(eval::default_eval_data), true);
+
+// The board as seen by one side, fixed at compile time. Every term below is
+// written once for Us and instantiated for both colours.
+template <chess::Color Us>
+struct Side {
+    static constexpr chess::Color Them = ~Us;
+    static constexpr chess::Piece Pawn = chess::make_piece(Us, chess::PAWN);
+    static constexpr chess::Piece Knight = chess::make_piece(Us, chess::KNIGHT);
+    static constexpr chess::Piece Bishop = chess::make_piece(Us, chess::BISHOP);
+    static constexpr chess::Piece Rook = chess::make_piece(Us, chess::ROOK);
+    static constexpr chess::Piece Queen = chess::make_piece(Us, chess::QUEEN);
+    static constexpr chess::Piece King = chess::make_piece(Us, chess::KING);
+    static constexpr chess::Piece EnemyPawn = chess::make_piece(Them, chess::PAWN);
+
+    static constexpr int Forward = (Us == chess::WHITE) ? 8 : -8;
+    static constexpr chess::Direction UpEast = (Us == chess::WHITE) ? chess::NORTH_EAST : chess::SOUTH_EAST;
+    static constexpr chess::Direction UpWest = (Us == chess::WHITE) ? chess::NORTH_WEST : chess::SOUTH_WEST;
+    static constexpr uint64_t EnemyHalf = (Us == chess::WHITE) ? util::black_side_of_board : util::white_side_of_board;
+    static constexpr int PawnHomeRank = (Us == chess::WHITE) ? 1 : 6;
+
+    static inline int relative_rank(chess::Square sq) { return (Us == chess::WHITE) ? util::get_rank(sq) : 7 - util::get_rank(sq); }
+    // Squares on adjacent and own files ahead of sq, and behind it
+    static inline uint64_t front_span(chess::Square sq) { return (Us == chess::WHITE) ? chess::passed_pawn_masks_white[sq] : chess::passed_pawn_masks_black[sq]; }
+    static inline uint64_t rear_span(chess::Square sq) { return (Us == chess::WHITE) ? chess::passed_pawn_masks_black[sq] : chess::passed_pawn_masks_white[sq]; }
+    static inline chess::Square king_square(const Board& b) { return (Us == chess::WHITE) ? b.white_king_sq : b.black_king_sq; }
+    // The rank of our pawn on a file nearest our own back rank
+    static inline chess::Square rearmost(uint64_t pawns) { return (Us == chess::WHITE) ? util::lsb(pawns) : util::msb(pawns); }
+};
+
+// Squares on or in front of bb, seen from each side
+static inline uint64_t north_fill(uint64_t bb) { bb |= bb << 8; bb |= bb << 16; bb |= bb << 32; return bb; }
+static inline uint64_t south_fill(uint64_t bb) { bb |= bb >> 8; bb |= bb >> 16; bb |= bb >> 32; return bb; }
+
+template <chess::Color Us>
+static inline void add_attacks(const eval::EvalData& p, eval::EvalContext& ctx, chess::PieceType pt, uint64_t attacks) {
+    ctx.attacked_by2[Us] |= ctx.attacked_by[Us][chess::NO_PIECE_TYPE] & attacks;
+    ctx.attacked_by[Us][chess::NO_PIECE_TYPE] |= attacks;
+    ctx.attacked_by[Us][pt] |= attacks;
+    ctx.king_attack_weight[Us] += p.king_attack_weights[pt] * util::count_bits(attacks & ctx.king_zone[Side<Us>::Them]);
+}
 
-    for (int df = -1; df <= 1; ++df) {
-        for (int dr = -1; dr <= 1; ++dr) {
-            if (df == 0 && dr == 0) continue;
+template <chess::Color Us, chess::PieceType Pt>
+static inline void add_piece_attacks(const Board& b, const eval::EvalData& p, eval::EvalContext& ctx) {
+    uint64_t pieces = b.bitboard[chess::make_piece(Us, Pt)];
+    while (pieces) {
+        chess::Square sq = util::pop_lsb(pieces);
+        uint64_t attacks;
+        if constexpr (Pt == chess::KNIGHT) attacks = chess::KnightAttacks[sq];
+        else if constexpr (Pt == chess::BISHOP) attacks = chess::get_diagonal_slider_attacks(sq, b.occupied);
+        else if constexpr (Pt == chess::ROOK) attacks = chess::get_orthogonal_slider_attacks(sq, b.occupied);
+        else if constexpr (Pt == chess::QUEEN) attacks = chess::get_diagonal_slider_attacks(sq, b.occupied) | chess::get_orthogonal_slider_attacks(sq, b.occupied);
+        else attacks = chess::KingAttacks[sq];
+        ctx.attacks_from[sq] = attacks;
+        add_attacks<Us>(p, ctx, Pt, attacks);
+    }
+}
 
-            int target_file = king_file + df;
-            int target_rank = king_rank + dr;
+template <chess::Color Us>
+static void build_side(const Board& b, const eval::EvalData& p, eval::EvalContext& ctx) {
+    using S = Side<Us>;
+    for (auto& bb : ctx.attacked_by[Us]) bb = 0;
+    ctx.attacked_by2[Us] = 0;
+    ctx.king_attack_weight[Us] = 0;
+
+    // Pawns go in as two sets so every (pawn, target) pair is weighted once
+    const uint64_t pawns = b.bitboard[S::Pawn];
+    add_attacks<Us>(p, ctx, chess::PAWN, util::shift_board(pawns, S::UpEast));
+    add_attacks<Us>(p, ctx, chess::PAWN, util::shift_board(pawns, S::UpWest));
+
+    add_piece_attacks<Us, chess::KNIGHT>(b, p, ctx);
+    add_piece_attacks<Us, chess::BISHOP>(b, p, ctx);
+    add_piece_attacks<Us, chess::ROOK>(b, p, ctx);
+    add_piece_attacks<Us, chess::QUEEN>(b, p, ctx);
+    add_piece_attacks<Us, chess::KING>(b, p, ctx);
+}
 
-            if (target_file >= 0 && target_file <= 7 && target_rank >= 0 && target_rank <= 7) {
-                chess::Square target_sq = chess::Square(target_rank * 8 + target_file);
-                uint64_t attackers = b.attackers_to(target_sq, by_white);
+void eval::build_context(const Board& b, const EvalData& p, EvalContext& ctx) {
+    // Both king zones are needed before either side's attacks are weighted
+    ctx.king_zone[chess::WHITE] = chess::KingAttacks[b.white_king_sq];
+    ctx.king_zone[chess::BLACK] = chess::KingAttacks[b.black_king_sq];
+    ctx.mobility_area[chess::WHITE] = ~b.white_occupied;
+    ctx.mobility_area[chess::BLACK] = ~b.black_occupied;
+    build_side<chess::WHITE>(b, p, ctx);
+    build_side<chess::BLACK>(b, p, ctx);
+}
 
-                while (attackers) {
-                    chess::Square attacker_sq = util::pop_lsb(attackers);
-                    chess::PieceType pt = chess::type_of(b.piece_on_sq(attacker_sq));
-                    attack_score += eval::eval_data.king_attack_weights[pt];
-                }
-            }
+template <chess::Color Us>
+static chess::Score king_safety(const Board& b, const eval::EvalData& p, const eval::EvalContext& ctx) {
+    using S = Side<Us>;
+    chess::Score score;
+    const int king_file = util::get_file(S::king_square(b));
+
+    // Pawn shield: the pawn nearest home on each file around the king
+    for (int file_idx = std::max(0, king_file - 1); file_idx <= std::min(7, king_file + 1); ++file_idx) {
+        uint64_t friendly_pawns = chess::files[file_idx] & b.bitboard[S::Pawn];
+        if (!friendly_pawns) {
+            score -= p.open_file_penalty;
+            continue;
+        }
+        int rank_dist = std::abs(util::get_rank(S::rearmost(friendly_pawns)) - S::PawnHomeRank);
+        if (rank_dist > 0 && rank_dist < (int)p.pawn_shield_penalty.size()) {
+            score -= p.pawn_shield_penalty[rank_dist];
         }
     }
 
-    int final_attack_index = std::min(attack_score, (int)eval::eval_data.king_safety_table.size() - 1);
-    safety_score.mg += eval::eval_data.king_safety_table[final_attack_index].mg;
-    safety_score.eg += eval::eval_data.king_safety_table[final_attack_index].eg;
-
-    return safety_score;
+    // Attacks on the king zone, summed while building the context
+    int attack_index = std::min(ctx.king_attack_weight[S::Them], (int)p.king_safety_table.size() - 1);
+    score += p.king_safety_table[attack_index];
+    return score;
 }
 
-eval::TaperedScore king_activity_score(const Board& b, chess::Color color) {
-    eval::TaperedScore activity_score = {0, 0};
-    const chess::Square king_square = (color == chess::WHITE) ? b.white_king_sq : b.black_king_sq;
-    const chess::Square opponent_king_square = (color == chess::WHITE) ? b.black_king_sq : b.white_king_sq;
+template <chess::Color Us>
+static chess::Score king_activity(const Board& b, const eval::EvalData& p) {
+    using S = Side<Us>;
+    const chess::Square king_square = S::king_square(b);
+    const chess::Square opponent_king_square = Side<S::Them>::king_square(b);
 
     const int king_rank = util::get_rank(king_square);
     const int king_file = util::get_file(king_square);
-    const int opponent_king_rank = util::get_rank(opponent_king_square);
-    const int opponent_king_file = util::get_file(opponent_king_square);
 
-    const int king_dist_to_center_rank = std::max(3 - king_rank, king_rank - 4);
-    const int king_dist_to_center_file = std::max(3 - king_file, king_file - 4);
-    const int king_dist_from_center = king_dist_to_center_file + king_dist_to_center_rank;
-    
     // Distance of King from Center
-    activity_score.eg -= king_dist_from_center * eval::eval_data.king_distance_from_center_penalty.eg;
-
-    const int dist_between_kings_rank = std::abs(opponent_king_rank - king_rank);
-    const int dist_between_kings_file = std::abs(opponent_king_file - king_file);
-    const int distance_between_kings = dist_between_kings_rank + dist_between_kings_file;
-
+    const int king_dist_from_center = std::max(3 - king_file, king_file - 4) + std::max(3 - king_rank, king_rank - 4);
     // Distance between Kings
-    activity_score.eg -= distance_between_kings * eval::eval_data.king_distance_from_opponent_king_penalty.eg;
+    const int distance_between_kings = std::abs(util::get_rank(opponent_king_square) - king_rank) + std::abs(util::get_file(opponent_king_square) - king_file);
 
-    return activity_score;
+    return chess::Score(0, -king_dist_from_center * p.king_distance_from_center_penalty.eg
+                           - distance_between_kings * p.king_distance_from_opponent_king_penalty.eg);
 }
 
-void pawn_evaluation(const Board& b, int& mg_score, int& eg_score) {
-    
-    // 1. White Pawns
-    uint64_t white_pawns = b.bitboard[chess::WP];
-
-    uint64_t white_pawns_east_attacks = util::shift_board(white_pawns, chess::NORTH_EAST) & util::black_side_of_board;
-    uint64_t white_pawns_west_attacks = util::shift_board(white_pawns, chess::NORTH_WEST) & util::black_side_of_board;
-    
-    uint64_t white_pawns_attacks = white_pawns_east_attacks | white_pawns_west_attacks;
-
-    // Pawn Chain
-    uint64_t pawn_chain_white = white_pawns_attacks & white_pawns;
-    int no_of_pawns_in_pawn_chain_white = util::count_bits(pawn_chain_white);
-
-    mg_score += eval::eval_data.pawn_chain_bonus[no_of_pawns_in_pawn_chain_white].mg;
-    eg_score += eval::eval_data.pawn_chain_bonus[no_of_pawns_in_pawn_chain_white].eg;
-    
-    // Space
-    int no_of_square_controlled_by_white = util::count_bits(white_pawns_attacks);
-
-    mg_score += no_of_square_controlled_by_white * eval::eval_data.controlled_square_bonus.mg;
-    eg_score += no_of_square_controlled_by_white * eval::eval_data.controlled_square_bonus.eg;
-    
-    while (white_pawns) {
-        chess::Square sq = util::pop_lsb(white_pawns);
-
-        // Material
-        mg_score += eval::eval_data.material_values[chess::PAWN].mg;
-        eg_score += eval::eval_data.material_values[chess::PAWN].eg;
-        
-        // PST(s)
-        mg_score += eval::eval_data.psts[chess::PAWN][sq].mg;
-        eg_score += eval::eval_data.psts[chess::PAWN][sq].eg;
-        
+// Pawn-only terms for one side; the result depends on nothing but the pawns
+template <chess::Color Us>
+static chess::Score pawn_terms(const Board& b, const eval::EvalData& p, PawnEntry& entry) {
+    using S = Side<Us>;
+    chess::Score score;
+    const uint64_t our_pawns = b.bitboard[S::Pawn];
+    const uint64_t their_pawns = b.bitboard[S::EnemyPawn];
+
+    entry.attacks[Us] = util::shift_board(our_pawns, S::UpEast) | util::shift_board(our_pawns, S::UpWest);
+    entry.attack_span[Us] = (Us == chess::WHITE) ? north_fill(entry.attacks[Us]) : south_fill(entry.attacks[Us]);
+    entry.passed[Us] = 0;
+
+    // Pawn chains and space count attacks in the enemy half only
+    const uint64_t attacks = entry.attacks[Us] & S::EnemyHalf;
+    score += p.pawn_chain_bonus[util::count_bits(attacks & our_pawns)];
+    score += util::count_bits(attacks) * p.controlled_square_bonus;
+
+    uint64_t pawns = our_pawns;
+    while (pawns) {
+        chess::Square sq = util::pop_lsb(pawns);
+
         // Passed Pawn Bonus
-        uint64_t passing_mask = chess::passed_pawn_masks_white[sq];
-        uint64_t enemy_pawns = b.bitboard[chess::BP] & passing_mask;
-        if ( !enemy_pawns ) {
-            mg_score += eval::eval_data.passed_pawn_bonus[util::get_rank(sq)].mg;
-            eg_score += eval::eval_data.passed_pawn_bonus[util::get_rank(sq)].eg;
+        if (!(their_pawns & S::front_span(sq))) {
+            entry.passed[Us] |= util::create_bitboard_from_square(sq);
+            score += p.passed_pawn_bonus[S::relative_rank(sq)];
         }
 
-        // Backward Pawn Penalty
-        uint64_t backward_mask = chess::passed_pawn_masks_black[sq];
-        uint64_t friendly_pawns = b.bitboard[chess::WP] & backward_mask;
-        if ( !friendly_pawns ){
-            uint64_t next_square_bitboard = util::shift_board(util::create_bitboard_from_square(sq), chess::NORTH);
-            int next_square = util::lsb(next_square_bitboard);
-            uint64_t next_square_attacking_mask = chess::PawnAttacks[chess::WHITE][next_square];
-
-            if ( next_square_attacking_mask & b.bitboard[chess::BP] ){
-                mg_score -= eval::eval_data.backward_pawn_penalty.mg;
-                eg_score -= eval::eval_data.backward_pawn_penalty.eg;
-            }
+        // Backward Pawn Penalty: no pawn beside or behind it, and its stop square is attacked
+        if (!(our_pawns & S::rear_span(sq)) && (chess::PawnAttacks[Us][sq + S::Forward] & their_pawns)) {
+            score -= p.backward_pawn_penalty;
         }
-        
+
         // Isolated Pawn Penalty
-        int file = util::get_file(sq);
-        uint64_t adjacent_files = eval::eval_data.adjacent_files_masks[file];
-        if (!(b.bitboard[chess::WP] & adjacent_files)) {
-            mg_score -= eval::eval_data.isolated_pawn_penalty.mg;
-            eg_score -= eval::eval_data.isolated_pawn_penalty.eg;
+        if (!(our_pawns & p.adjacent_files_masks[util::get_file(sq)])) {
+            score -= p.isolated_pawn_penalty;
         }
     }
-    
-    // 2. Black Pawns
-    uint64_t black_pawns = b.bitboard[chess::BP];
-
-    uint64_t black_pawns_east_attacks = util::shift_board(black_pawns, chess::SOUTH_EAST) & util::white_side_of_board;
-    uint64_t black_pawns_west_attacks = util::shift_board(black_pawns, chess::SOUTH_WEST) & util::white_side_of_board;
-    
-    uint64_t black_pawns_attacks = black_pawns_east_attacks | black_pawns_west_attacks;
-    
-    // Pawn Chain
-    uint64_t pawn_chain_black = black_pawns_attacks & black_pawns;
-    int no_of_pawns_in_pawn_chain_black = util::count_bits(pawn_chain_black);
-    
-    mg_score -= eval::eval_data.pawn_chain_bonus[no_of_pawns_in_pawn_chain_black].mg;
-    eg_score -= eval::eval_data.pawn_chain_bonus[no_of_pawns_in_pawn_chain_black].eg;
-    
-    // Space
-    int no_of_square_controlled_by_black = util::count_bits(black_pawns_attacks);
-    
-    mg_score -= no_of_square_controlled_by_black * eval::eval_data.controlled_square_bonus.mg;
-    eg_score -= no_of_square_controlled_by_black * eval::eval_data.controlled_square_bonus.eg;
-
-    while (black_pawns) {
-        chess::Square sq = util::pop_lsb(black_pawns);
-
-        // Material
-        mg_score -= eval::eval_data.material_values[chess::PAWN].mg;
-        eg_score -= eval::eval_data.material_values[chess::PAWN].eg;
-        
-        chess::Square pst_sq = util::flip(sq);
-
-        // PST(s)
-        mg_score -= eval::eval_data.psts[chess::PAWN][pst_sq].mg;
-        eg_score -= eval::eval_data.psts[chess::PAWN][pst_sq].eg;
-        
-        // Passed Pawn Bonus
-        uint64_t passing_mask = chess::passed_pawn_masks_black[sq];
-        uint64_t enemy_pawns = b.bitboard[chess::WP] & passing_mask;
-        if ( !enemy_pawns ) {
-            mg_score -= eval::eval_data.passed_pawn_bonus[util::get_rank(pst_sq)].mg;
-            eg_score -= eval::eval_data.passed_pawn_bonus[util::get_rank(pst_sq)].eg;
-        }
 
-        // Backward Pawn Penalty
-        uint64_t backward_mask = chess::passed_pawn_masks_black[sq];
-        uint64_t friendly_pawns = b.bitboard[chess::BP] & backward_mask;
-        if ( !friendly_pawns ){
-            uint64_t next_square_bitboard = util::shift_board(util::create_bitboard_from_square(sq), chess::SOUTH);
-            int next_square = util::lsb(next_square_bitboard);
-            uint64_t next_square_attacking_mask = chess::PawnAttacks[chess::BLACK][next_square];
-
-            if ( next_square_attacking_mask & b.bitboard[chess::WP] ){
-                mg_score += eval::eval_data.backward_pawn_penalty.mg;
-                eg_score += eval::eval_data.backward_pawn_penalty.eg;
-            }
-        }
-        
-        // Isolated Pawn Penalty
-        int file = util::get_file(sq);
-        uint64_t adjacent_files = eval::eval_data.adjacent_files_masks[file];
-        if (!(b.bitboard[chess::BP] & adjacent_files)) {
-            mg_score += eval::eval_data.isolated_pawn_penalty.mg;
-            eg_score += eval::eval_data.isolated_pawn_penalty.eg;
-        }
-    }    
-    
     // Doubled Pawns Penalty
     for (auto file : chess::files) {
-        uint64_t pawns_on_file_white = b.bitboard[chess::WP] & file;
-        int no_of_doubled_pawns_white = util::count_bits(pawns_on_file_white);
-        if (no_of_doubled_pawns_white > 1) {
-            mg_score -= eval::eval_data.doubled_pawn_penalty.mg * (no_of_doubled_pawns_white - 1);
-            eg_score -= eval::eval_data.doubled_pawn_penalty.eg * (no_of_doubled_pawns_white - 1);
-        }
-        uint64_t pawns_on_file_black = b.bitboard[chess::BP] & file;
-        int no_of_doubled_pawns_black = util::count_bits(pawns_on_file_black);
-        if (no_of_doubled_pawns_black > 1) {
-            mg_score += eval::eval_data.doubled_pawn_penalty.mg * (no_of_doubled_pawns_black - 1);
-            eg_score += eval::eval_data.doubled_pawn_penalty.eg * (no_of_doubled_pawns_black - 1);
-        }
+        int pawns_on_file = util::count_bits(our_pawns & file);
+        if (pawns_on_file > 1) score -= (pawns_on_file - 1) * p.doubled_pawn_penalty;
     }
+    return score;
 }
 
-void knight_evaluation(const Board& b, int& mg_score, int& eg_score) {
-    // 1. White Knights
-    uint64_t white_knights = b.bitboard[chess::WN];
-    while (white_knights) {
-        chess::Square sq = util::pop_lsb(white_knights);
-        
-        // Material
-        mg_score += eval::eval_data.material_values[chess::KNIGHT].mg;
-        eg_score += eval::eval_data.material_values[chess::KNIGHT].eg;
-        
-        // PST(s)
-        mg_score += eval::eval_data.psts[chess::KNIGHT][sq].mg;
-        eg_score += eval::eval_data.psts[chess::KNIGHT][sq].eg;
-
-        // Knight Outpost
-        uint64_t knight_outpost_square = chess::PawnAttacks[chess::BLACK][sq];
-        if (knight_outpost_square & b.bitboard[chess::WP]){
-            mg_score += eval::eval_data.knight_outpost_bonus.mg;
-            eg_score += eval::eval_data.knight_outpost_bonus.eg;
-        }
-
-        // Mobility
-        uint64_t knight_moves_bitboard = chess::KnightAttacks[sq] & (~b.white_occupied);
-        int knight_moves = util::count_bits(knight_moves_bitboard);
-        mg_score += eval::eval_data.mobility_bonus[chess::KNIGHT][knight_moves].mg;
-        eg_score += eval::eval_data.mobility_bonus[chess::KNIGHT][knight_moves].eg;
-
-        // Space 
-        uint64_t knight_attacks_on_black_side = chess::KnightAttacks[sq] & util::black_side_of_board;
-
-        int no_of_square_controlled_by_white = util::count_bits(knight_attacks_on_black_side);
-
-        mg_score += no_of_square_controlled_by_white * eval::eval_data.controlled_square_bonus.mg;
-        eg_score += no_of_square_controlled_by_white * eval::eval_data.controlled_square_bonus.eg;
+static chess::Score pawn_evaluation(const Board& b, const eval::EvalData& p, PawnTable* pawns) {
+    PawnEntry local;
+    PawnEntry* entry = &local;
+    bool found = false;
+    if (pawns) entry = &pawns->probe(b.zobrist_pawn_key, found);
+    if (!found) {
+        entry->score = pawn_terms<chess::WHITE>(b, p, *entry) - pawn_terms<chess::BLACK>(b, p, *entry);
+        entry->key = b.zobrist_pawn_key;
     }
-    
-    // 2. Black Knights
-    uint64_t black_knights = b.bitboard[chess::BN];
-    while (black_knights) {
-        chess::Square sq = util::pop_lsb(black_knights);
-
-        // Material
-        mg_score -= eval::eval_data.material_values[chess::KNIGHT].mg;
-        eg_score -= eval::eval_data.material_values[chess::KNIGHT].eg;
-
-        int pst_sq = util::flip(sq);
-
-        // PST(s)
-        mg_score -= eval::eval_data.psts[chess::KNIGHT][pst_sq].mg;
-        eg_score -= eval::eval_data.psts[chess::KNIGHT][pst_sq].eg;
-
-        // knight outpost
-        uint64_t knight_outpost_square = chess::PawnAttacks[chess::WHITE][sq];
-        if (knight_outpost_square & b.bitboard[chess::BP]){
-            mg_score -= eval::eval_data.knight_outpost_bonus.mg;
-            eg_score -= eval::eval_data.knight_outpost_bonus.eg;
-        }
+    return entry->score;
+}
 
-        // Mobility
-        uint64_t knight_moves_bitboard = chess::KnightAttacks[sq] & (~b.black_occupied);
-        int knight_moves = util::count_bits(knight_moves_bitboard);
-        mg_score -= eval::eval_data.mobility_bonus[chess::KNIGHT][knight_moves].mg;
-        eg_score -= eval::eval_data.mobility_bonus[chess::KNIGHT][knight_moves].eg;
+// Mobility over the mobility area and space in the enemy half
+template <chess::Color Us, chess::PieceType Pt>
+static inline chess::Score mobility_and_space(const eval::EvalData& p, uint64_t attacks, const eval::EvalContext& ctx) {
+    const uint64_t moves = attacks & ctx.mobility_area[Us];
+    // Queens count only the squares they can move to as space
+    const uint64_t space = ((Pt == chess::QUEEN) ? moves : attacks) & Side<Us>::EnemyHalf;
+    return p.mobility_bonus[Pt][util::count_bits(moves)]
+         + util::count_bits(space) * p.controlled_square_bonus;
+}
 
-        // Space 
-        uint64_t knight_attacks_on_white_side = chess::KnightAttacks[sq] & util::white_side_of_board;
+template <chess::Color Us>
+static chess::Score knight_terms(const Board& b, const eval::EvalData& p, const eval::EvalContext& ctx) {
+    using S = Side<Us>;
+    chess::Score score;
+    uint64_t knights = b.bitboard[S::Knight];
+    while (knights) {
+        chess::Square sq = util::pop_lsb(knights);
 
-        int no_of_square_controlled_by_black = util::count_bits(knight_attacks_on_white_side);
+        // Knight Outpost: defended by one of our pawns
+        if (chess::PawnAttacks[S::Them][sq] & b.bitboard[S::Pawn]) score += p.knight_outpost_bonus;
 
-        mg_score -= no_of_square_controlled_by_black * eval::eval_data.controlled_square_bonus.mg;
-        eg_score -= no_of_square_controlled_by_black * eval::eval_data.controlled_square_bonus.eg;
+        score += mobility_and_space<Us, chess::KNIGHT>(p, ctx.attacks_from[sq], ctx);
     }
+    return score;
 }
 
-void bishop_evaluation(const Board& b, int& mg_score, int& eg_score) {
-    // 1. White Bishops
-    uint64_t white_bishops = b.bitboard[chess::WB];
-    while (white_bishops) {
-        chess::Square sq = util::pop_lsb(white_bishops);
-
-        // Material
-        mg_score += eval::eval_data.material_values[chess::BISHOP].mg;
-        eg_score += eval::eval_data.material_values[chess::BISHOP].eg;
-        
-        // PST(s)
-        mg_score += eval::eval_data.psts[chess::BISHOP][sq].mg;
-        eg_score += eval::eval_data.psts[chess::BISHOP][sq].eg;
-
-        uint64_t pawns_of_required_color;
-        if (util::create_bitboard_from_square(sq) & util::black_squares) pawns_of_required_color = b.bitboard[chess::WP] & util::white_squares;
-        else pawns_of_required_color = b.bitboard[chess::WP] & util::black_squares;
-
-        int no_of_pawns_on_required_color = util::count_bits(pawns_of_required_color);
-
-        // Good Bishop Bonus
-        mg_score += no_of_pawns_on_required_color * eval::eval_data.good_bishop_bonus.mg;
-        eg_score += no_of_pawns_on_required_color * eval::eval_data.good_bishop_bonus.eg;
+template <chess::Color Us>
+static chess::Score bishop_terms(const Board& b, const eval::EvalData& p, const eval::EvalContext& ctx) {
+    using S = Side<Us>;
+    chess::Score score;
+    uint64_t bishops = b.bitboard[S::Bishop];
+    while (bishops) {
+        chess::Square sq = util::pop_lsb(bishops);
 
-        // Mobility
-        uint64_t bishop_moves_bitboard = chess::get_diagonal_slider_attacks(sq, b.occupied) & (~b.white_occupied);
-        int bishop_moves = util::count_bits(bishop_moves_bitboard);
-        mg_score += eval::eval_data.mobility_bonus[chess::BISHOP][bishop_moves].mg;
-        eg_score += eval::eval_data.mobility_bonus[chess::BISHOP][bishop_moves].eg;
+        // Good Bishop Bonus: our pawns on the other square colour
+        const uint64_t other_colour = (util::create_bitboard_from_square(sq) & util::black_squares) ? util::white_squares : util::black_squares;
+        score += util::count_bits(b.bitboard[S::Pawn] & other_colour) * p.good_bishop_bonus;
 
-        // Space 
-        uint64_t bishop_attacks_on_balck_side = chess::get_diagonal_slider_attacks(sq, b.occupied) & util::black_side_of_board;
-
-        int no_of_square_controlled_by_white = util::count_bits(bishop_attacks_on_balck_side);
-
-        mg_score += no_of_square_controlled_by_white * eval::eval_data.controlled_square_bonus.mg;
-        eg_score += no_of_square_controlled_by_white * eval::eval_data.controlled_square_bonus.eg;
+        score += mobility_and_space<Us, chess::BISHOP>(p, ctx.attacks_from[sq], ctx);
     }
-    
-    // 2. Black Bishops
-    uint64_t black_bishops = b.bitboard[chess::BB];
-    while (black_bishops) {
-        chess::Square sq = util::pop_lsb(black_bishops);
 
-        // Material
-        mg_score -= eval::eval_data.material_values[chess::BISHOP].mg;
-        eg_score -= eval::eval_data.material_values[chess::BISHOP].eg;
+    // Bishop Pair Bonus
+    if (util::count_bits(b.bitboard[S::Bishop]) >= 2) score += p.bishop_pair_bonus;
+    return score;
+}
 
-        int pst_sq = util::flip(sq);
+template <chess::Color Us>
+static chess::Score rook_terms(const Board& b, const eval::EvalData& p, const eval::EvalContext& ctx) {
+    using S = Side<Us>;
+    chess::Score score;
+    uint64_t rooks = b.bitboard[S::Rook];
+    while (rooks) {
+        chess::Square sq = util::pop_lsb(rooks);
+        const uint64_t attacks = ctx.attacks_from[sq];
 
-        // PST(s)
-        mg_score -= eval::eval_data.psts[chess::BISHOP][pst_sq].mg;
-        eg_score -= eval::eval_data.psts[chess::BISHOP][pst_sq].eg;
+        // 7th Rank Bonus
+        if (S::relative_rank(sq) == 6) score += p.rook_on_7th_bonus;
 
-        uint64_t black_pawns_of_required_color;
-        if (util::create_bitboard_from_square(sq) & util::black_squares) black_pawns_of_required_color = b.bitboard[chess::BP] & util::white_squares;
-        else black_pawns_of_required_color = b.bitboard[chess::BP] & util::black_squares;
+        // Open and Semi Open files
+        const uint64_t file_mask = chess::files[util::get_file(sq)];
+        if (!(file_mask & b.bitboard[S::Pawn])) {
+            score += (file_mask & b.bitboard[S::EnemyPawn]) ? p.rook_on_semi_open_file_bonus : p.rook_on_open_file_bonus;
+        }
 
-        int no_of_pawns_on_bishop_color = util::count_bits(black_pawns_of_required_color);
+        // Connected Rooks: counted once per pair, by the rook popped first
+        if (attacks & rooks) score += p.rook_connected_bonus;
 
-        // Good Bishop bonus
-        mg_score -= no_of_pawns_on_bishop_color * eval::eval_data.good_bishop_bonus.mg;
-        eg_score -= no_of_pawns_on_bishop_color * eval::eval_data.good_bishop_bonus.eg;
+        score += mobility_and_space<Us, chess::ROOK>(p, attacks, ctx);
+    }
+    return score;
+}
 
-        // Mobility
-        uint64_t bishop_moves_bitboard = chess::get_diagonal_slider_attacks(sq, b.occupied) & (~b.black_occupied);
-        int bishop_moves = util::count_bits(bishop_moves_bitboard);
-        mg_score -= eval::eval_data.mobility_bonus[chess::BISHOP][bishop_moves].mg;
-        eg_score -= eval::eval_data.mobility_bonus[chess::BISHOP][bishop_moves].eg;
+template <chess::Color Us>
+static chess::Score queen_terms(const Board& b, const eval::EvalData& p, const eval::EvalContext& ctx) {
+    chess::Score score;
+    uint64_t queens = b.bitboard[Side<Us>::Queen];
+    while (queens) {
+        chess::Square sq = util::pop_lsb(queens);
+        score += mobility_and_space<Us, chess::QUEEN>(p, ctx.attacks_from[sq], ctx);
+    }
+    return score;
+}
 
-        // Space 
-        uint64_t bishop_attacks_on_white_side = chess::get_diagonal_slider_attacks(sq, b.occupied) & util::white_side_of_board;
+// Every non-pawn term for one side; the Trace instantiation also records each one
+template <chess::Color Us, bool Trace>
+static chess::Score piece_terms(const Board& b, const eval::EvalData& p, const eval::EvalContext& ctx, eval::Trace* trace) {
+    if constexpr (Trace) {
+        trace->terms[eval::TERM_KNIGHTS][Us] = knight_terms<Us>(b, p, ctx);
+        trace->terms[eval::TERM_BISHOPS][Us] = bishop_terms<Us>(b, p, ctx);
+        trace->terms[eval::TERM_ROOKS][Us] = rook_terms<Us>(b, p, ctx);
+        trace->terms[eval::TERM_QUEENS][Us] = queen_terms<Us>(b, p, ctx);
+        trace->terms[eval::TERM_KING_SAFETY][Us] = king_safety<Us>(b, p, ctx);
+        trace->terms[eval::TERM_KING_ACTIVITY][Us] = king_activity<Us>(b, p);
+        chess::Score sum;
+        for (int t = eval::TERM_KNIGHTS; t <= eval::TERM_KING_ACTIVITY; ++t) sum += trace->terms[t][Us];
+        return sum;
+    } else {
+        return knight_terms<Us>(b, p, ctx) + bishop_terms<Us>(b, p, ctx) + rook_terms<Us>(b, p, ctx) + queen_terms<Us>(b, p, ctx)
+             + king_safety<Us>(b, p, ctx) + king_activity<Us>(b, p);
+    }
+}
 
-        int no_of_square_controlled_by_black = util::count_bits(bishop_attacks_on_white_side);
+// Blends white's mg/eg scores by game phase and returns them for the side to move
+static inline int taper(const Board& b, chess::Score score) {
+    const int phase = std::min(b.game_phase, util::TOTAL_PHASE); // promotions can push it past the start
+    int final_score = (score.mg() * phase + score.eg() * (util::TOTAL_PHASE - phase)) / util::TOTAL_PHASE;
+    return b.white_to_move ? final_score : -final_score;
+}
 
-        mg_score -= no_of_square_controlled_by_black * eval::eval_data.controlled_square_bonus.mg;
-        eg_score -= no_of_square_controlled_by_black * eval::eval_data.controlled_square_bonus.eg;
+// Material and PSTs for one side, from its own point of view
+template <chess::Color Us>
+static chess::Score material_terms(const Board& b) {
+    chess::Score score;
+    for (int pt = chess::PAWN; pt <= chess::KING; ++pt) {
+        const chess::Piece piece = chess::make_piece(Us, (chess::PieceType)pt);
+        uint64_t pieces = b.bitboard[piece];
+        while (pieces) score += psqt::table[piece][util::pop_lsb(pieces)];
     }
+    return Us == chess::WHITE ? score : -score;
+}
 
-    // Bishop Pair Bonus
-    int white_bishops_count = util::count_bits(b.bitboard[chess::WB]);
-    int black_bishops_count = util::count_bits(b.bitboard[chess::BB]);
-    
-    if (white_bishops_count >= 2) {
-        mg_score += eval::eval_data.bishop_pair_bonus.mg;
-        eg_score += eval::eval_data.bishop_pair_bonus.eg;
+template <bool Trace>
+static inline int evaluate_with(const Board& b, const eval::EvalData& p, PawnTable* pawns, eval::Trace* trace = nullptr) {
+    eval::EvalContext ctx;
+    eval::build_context(b, p, ctx);
+
+    // Material and PSTs are kept up to date by make_move
+    chess::Score score = b.psq_score;
+    if constexpr (Trace) {
+        // Each side's pawn terms on their own; the pawn hash only keeps the difference
+        PawnEntry entry;
+        trace->terms[eval::TERM_MATERIAL][chess::WHITE] = material_terms<chess::WHITE>(b);
+        trace->terms[eval::TERM_MATERIAL][chess::BLACK] = material_terms<chess::BLACK>(b);
+        trace->terms[eval::TERM_PAWNS][chess::WHITE] = pawn_terms<chess::WHITE>(b, p, entry);
+        trace->terms[eval::TERM_PAWNS][chess::BLACK] = pawn_terms<chess::BLACK>(b, p, entry);
+        score += trace->terms[eval::TERM_PAWNS][chess::WHITE] - trace->terms[eval::TERM_PAWNS][chess::BLACK];
+    } else {
+        score += pawn_evaluation(b, p, pawns);
     }
-    if (black_bishops_count >= 2) {
-        mg_score -= eval::eval_data.bishop_pair_bonus.mg;
-        eg_score -= eval::eval_data.bishop_pair_bonus.eg;
+    score += piece_terms<chess::WHITE, Trace>(b, p, ctx, trace) - piece_terms<chess::BLACK, Trace>(b, p, ctx, trace);
+    const int result = taper(b, score);
+    if constexpr (Trace) {
+        trace->phase = std::min(b.game_phase, util::TOTAL_PHASE);
+        trace->score = result;
     }
+    return result;
 }
 
-void rook_evaluation(const Board& b, int& mg_score, int& eg_score) {
-    // 1. White Rooks
-    uint64_t white_rooks = b.bitboard[chess::WR];
-    while (white_rooks) {
-        chess::Square sq = util::pop_lsb(white_rooks);
-        // Material Score
-        mg_score += eval::eval_data.material_values[chess::ROOK].mg;
-        eg_score += eval::eval_data.material_values[chess::ROOK].eg;
-        
-        // PST
-        mg_score += eval::eval_data.psts[chess::ROOK][sq].mg;
-        eg_score += eval::eval_data.psts[chess::ROOK][sq].eg;
+int Search::evaluate(const Board& b, PawnTable* pawns) {
+    if (nnue::enabled()) return nnue::evaluate(b);
 
-        // 7th Rank Bonus
-        int rook_rank = util::get_rank(sq);
-        if (rook_rank == 6){
-            mg_score += eval::eval_data.rook_on_7th_bonus.mg;
-            eg_score += eval::eval_data.rook_on_7th_bonus.eg;
-        }
-
-        // Open and Semi Open files
-        int rook_file = util::get_file(sq);
-        uint64_t file_mask = chess::files[rook_file];
-        bool no_friendly_pawns = (file_mask & b.bitboard[chess::WP]) == 0;
-        bool no_enemy_pawns = (file_mask & b.bitboard[chess::BP]) == 0;   
-
-        if (no_friendly_pawns) {
-            if (no_enemy_pawns) {
-                // Open File
-                mg_score += eval::eval_data.rook_on_open_file_bonus.mg;
-                eg_score += eval::eval_data.rook_on_open_file_bonus.eg;
-            } 
-            else {
-                // Semi-Open File
-                mg_score += eval::eval_data.rook_on_semi_open_file_bonus.mg;
-                eg_score += eval::eval_data.rook_on_semi_open_file_bonus.eg;
-            }
-        }  
-        
-        // Connected Rooks
-        uint64_t rook_attack_mask = chess::get_orthogonal_slider_attacks(sq, b.occupied);
-        if (rook_attack_mask & white_rooks){
-            mg_score += eval::eval_data.rook_connected_bonus.mg;
-            eg_score += eval::eval_data.rook_connected_bonus.eg;
-        }
-
-        // Mobility
-        uint64_t rook_moves_bitboard = chess::get_orthogonal_slider_attacks(sq, b.occupied) & (~b.white_occupied);
-        int rook_moves = util::count_bits(rook_moves_bitboard);
-        mg_score += eval::eval_data.mobility_bonus[chess::ROOK][rook_moves].mg;
-        eg_score += eval::eval_data.mobility_bonus[chess::ROOK][rook_moves].eg;
-
-        // Space 
-        uint64_t rook_attacks_on_black_side = rook_attack_mask & util::black_side_of_board;
-
-        int no_of_square_controlled_by_white = util::count_bits(rook_attacks_on_black_side);
-
-        mg_score += no_of_square_controlled_by_white * eval::eval_data.controlled_square_bonus.mg;
-        eg_score += no_of_square_controlled_by_white * eval::eval_data.controlled_square_bonus.eg;
-    }
-    
-    // 2. Black Rooks
-    uint64_t black_rooks = b.bitboard[chess::BR];
-    while (black_rooks) {
-        // Materail Score
-        chess::Square sq = util::pop_lsb(black_rooks);
-        mg_score -= eval::eval_data.material_values[chess::ROOK].mg;
-        eg_score -= eval::eval_data.material_values[chess::ROOK].eg;
-
-        // Positional Score
-        int pst_sq = util::flip(sq);
-        mg_score -= eval::eval_data.psts[chess::ROOK][pst_sq].mg;
-        eg_score -= eval::eval_data.psts[chess::ROOK][pst_sq].eg;
-
-        // Rook on 7th Rank
-        int rook_rank = util::get_rank(sq);
-        if (rook_rank == 1){
-            mg_score -= eval::eval_data.rook_on_7th_bonus.mg;
-            eg_score -= eval::eval_data.rook_on_7th_bonus.eg;
-        }
-        
-        // Open and Semi Open files
-        int rook_file = util::get_file(sq);
-        uint64_t file_mask = chess::files[rook_file];
-        bool no_friendly_pawns = (file_mask & b.bitboard[chess::BP]) == 0;
-        bool no_enemy_pawns = (file_mask & b.bitboard[chess::WP]) == 0;   
-
-        if (no_friendly_pawns) {
-            if (no_enemy_pawns) {
-                // Open File
-                mg_score -= eval::eval_data.rook_on_open_file_bonus.mg;
-                eg_score -= eval::eval_data.rook_on_open_file_bonus.eg;
-            } 
-            else {
-                // Semi-Open File
-                mg_score -= eval::eval_data.rook_on_semi_open_file_bonus.mg;
-                eg_score -= eval::eval_data.rook_on_semi_open_file_bonus.eg;
-            }
-        }
-
-        // Connected Rooks
-        uint64_t rook_attack_mask = chess::get_orthogonal_slider_attacks(sq, b.occupied);
-        if (rook_attack_mask & black_rooks){
-            mg_score -= eval::eval_data.rook_connected_bonus.mg;
-            eg_score -= eval::eval_data.rook_connected_bonus.eg;
-        }
+    // With the defaults active the compiler sees the constexpr table and folds
+    // the parameters into the code; a loaded set is read through the pointer
+    if (eval::active == &eval::default_eval_data) return evaluate_with<false>(b, eval::default_eval_data, pawns);
+    return evaluate_with<false>(b, *eval::active, pawns);
+}
 
-        // Mobility
-        uint64_t rook_moves_bitboard = chess::get_orthogonal_slider_attacks(sq, b.occupied) & (~b.black_occupied);
-        int rook_moves = util::count_bits(rook_moves_bitboard);
-        mg_score -= eval::eval_data.mobility_bonus[chess::ROOK][rook_moves].mg;
-        eg_score -= eval::eval_data.mobility_bonus[chess::ROOK][rook_moves].eg;
+int Search::lazy_evaluate(const Board& b) {
+    return taper(b, b.psq_score);
+}
 
-        // Space 
-        uint64_t rook_attacks_on_white_side = rook_attack_mask & util::white_side_of_board;
+// ----------------- Trace and profiling -----------------
 
-        int no_of_square_controlled_by_black = util::count_bits(rook_attacks_on_white_side);
+const char* const eval::TERM_NAMES[TERM_NB] = {
+    "Material", "Pawns", "Knights", "Bishops", "Rooks", "Queens", "King safety", "King activity"
+};
 
-        mg_score -= no_of_square_controlled_by_black * eval::eval_data.controlled_square_bonus.mg;
-        eg_score -= no_of_square_controlled_by_black * eval::eval_data.controlled_square_bonus.eg;
-    }
+int eval::trace(const Board& b, Trace& t) {
+    t = Trace{};
+    return evaluate_with<true>(b, *active, nullptr, &t);
 }
 
-void queen_evaluation(const Board& b, int& mg_score, int& eg_score) {
-    // 1. White Queens
-    uint64_t white_queens = b.bitboard[chess::WQ];
-    while (white_queens) {
-        chess::Square sq = util::pop_lsb(white_queens);
-
-        // Material
-        mg_score += eval::eval_data.material_values[chess::QUEEN].mg;
-        eg_score += eval::eval_data.material_values[chess::QUEEN].eg;
-        
-        // PST(s)
-        mg_score += eval::eval_data.psts[chess::QUEEN][sq].mg;
-        eg_score += eval::eval_data.psts[chess::QUEEN][sq].eg;
-
-        uint64_t attack_mask = chess::get_diagonal_slider_attacks(sq, b.occupied) | chess::get_orthogonal_slider_attacks(sq, b.occupied);
-        attack_mask = attack_mask & (!b.white_occupied);
-
-        // Mobility
-        int queen_moves = util::count_bits(attack_mask);
-        mg_score += eval::eval_data.mobility_bonus[chess::QUEEN][queen_moves].mg;
-        eg_score += eval::eval_data.mobility_bonus[chess::QUEEN][queen_moves].eg;
-        
-        // Space 
-        uint64_t queen_attacks_on_black_side = attack_mask & util::black_side_of_board;
-
-        int no_of_square_controlled_by_white = util::count_bits(queen_attacks_on_black_side);
-
-        mg_score += no_of_square_controlled_by_white * eval::eval_data.controlled_square_bonus.mg;
-        eg_score += no_of_square_controlled_by_white * eval::eval_data.controlled_square_bonus.eg;
-    }
-    
-    // 2. Black Queens
-    uint64_t black_queens = b.bitboard[chess::BQ];
-    while (black_queens) {
-        chess::Square sq = util::pop_lsb(black_queens);
-
-        // Material
-        mg_score -= eval::eval_data.material_values[chess::QUEEN].mg;
-        eg_score -= eval::eval_data.material_values[chess::QUEEN].eg;
-
-        int pst_sq = util::flip(sq);
-
-        // PST(s)
-        mg_score -= eval::eval_data.psts[chess::QUEEN][pst_sq].mg;
-        eg_score -= eval::eval_data.psts[chess::QUEEN][pst_sq].eg;
-
-        uint64_t attack_mask = chess::get_diagonal_slider_attacks(sq, b.occupied) | chess::get_orthogonal_slider_attacks(sq, b.occupied);
-        attack_mask = attack_mask & (~b.black_occupied);
-        
-        // Mobility
-        int queen_moves = util::count_bits(attack_mask);
-        mg_score -= eval::eval_data.mobility_bonus[chess::QUEEN][queen_moves].mg;
-        eg_score -= eval::eval_data.mobility_bonus[chess::QUEEN][queen_moves].eg;
-        
-        // Space 
-        uint64_t queen_attacks_on_white_side = attack_mask & util::white_side_of_board;
-        int no_of_square_controlled_by_black = util::count_bits(queen_attacks_on_white_side);
-
-        mg_score -= no_of_square_controlled_by_black * eval::eval_data.controlled_square_bonus.mg;
-        eg_score -= no_of_square_controlled_by_black * eval::eval_data.controlled_square_bonus.eg;
+std::string eval::format_trace(const Trace& t) {
+    std::ostringstream out;
+    auto cell = [&out](chess::Score s) { out << std::setw(6) << s.mg() << std::setw(6) << s.eg() << "  |"; };
+    const char* rule = " --------------+--------------+--------------+--------------+--------\n";
+    out << "          Term |    White     |    Black     |    Total     | Tapered\n"
+        << "               |    MG    EG  |    MG    EG  |    MG    EG  |\n" << rule;
+
+    chess::Score white, black;
+    for (int term = 0; term < TERM_NB; ++term) {
+        const chess::Score w = t.terms[term][chess::WHITE], bl = t.terms[term][chess::BLACK];
+        white += w;
+        black += bl;
+        out << std::setw(14) << TERM_NAMES[term] << " |";
+        cell(w);
+        cell(bl);
+        cell(w - bl);
+        out << std::setw(7) << t.tapered(w - bl) << "\n";
     }
+    out << rule << std::setw(14) << "Total" << " |";
+    cell(white);
+    cell(black);
+    cell(white - black);
+    out << std::setw(7) << t.tapered(white - black) << "\n\n"
+        << "Phase " << t.phase << "/" << util::TOTAL_PHASE << ", evaluation for the side to move: " << t.score << "\n";
+    return out.str();
 }
 
-void king_evaluation(const Board& b, int& mg_score, int& eg_score) {
-    // 1. White King
-    uint64_t white_king = b.bitboard[chess::WK];
-    if (white_king) {
-        chess::Square sq = util::pop_lsb(white_king);
-
-        mg_score += eval::eval_data.psts[chess::KING][sq].mg;
-        eg_score += eval::eval_data.psts[chess::KING][sq].eg;
-    }
-    
-    // 2. Black King
-    uint64_t black_king = b.bitboard[chess::BK];
-    if (black_king) {
-        chess::Square sq = util::pop_lsb(black_king);
-
-        int pst_sq = util::flip(sq);
-        mg_score -= eval::eval_data.psts[chess::KING][pst_sq].mg;
-        eg_score -= eval::eval_data.psts[chess::KING][pst_sq].eg;
+std::vector<eval::TermCost> eval::profile_terms(const std::vector<Board>& positions, int runs) {
+    // Material needs no time here: make_move keeps psq_score up to date
+    std::vector<TermCost> costs;
+    for (int term = TERM_PAWNS; term < TERM_NB; ++term) costs.push_back({TERM_NAMES[term]});
+    costs.push_back({"Attack maps"});
+    costs.push_back({"Evaluation"});
+
+    // Blocks of positions whose attack maps stay in cache, so the terms are timed
+    // rather than the memory holding their inputs
+    constexpr size_t BLOCK = 64;
+    const EvalData& p = *active;
+    EvalContext contexts[BLOCK];
+    uint32_t sink = 0; // every result feeds it so no term is optimised away
+
+    for (size_t first = 0; first < positions.size(); first += BLOCK) {
+        const size_t count = std::min(BLOCK, positions.size() - first);
+        const Board* boards = &positions[first];
+        for (size_t i = 0; i < count; ++i) build_context(boards[i], p, contexts[i]);
+
+        size_t index = 0;
+        auto time = [&](auto&& term) {
+            for (size_t i = 0; i < count; ++i) sink += term(boards[i], contexts[i]).value; // warm-up
+            const auto start = std::chrono::steady_clock::now();
+            const uint64_t start_tsc = read_tsc();
+            for (int run = 0; run < runs; ++run) {
+                for (size_t i = 0; i < count; ++i) sink += term(boards[i], contexts[i]).value;
+            }
+            costs[index].cycles += double(read_tsc() - start_tsc);
+            costs[index++].ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        };
+
+        time([&](const Board& b, const EvalContext&) {
+            PawnEntry entry;
+            return pawn_terms<chess::WHITE>(b, p, entry) - pawn_terms<chess::BLACK>(b, p, entry);
+        });
+        time([&](const Board& b, const EvalContext& ctx) {
+            return knight_terms<chess::WHITE>(b, p, ctx) - knight_terms<chess::BLACK>(b, p, ctx);
+        });
+        time([&](const Board& b, const EvalContext& ctx) {
+            return bishop_terms<chess::WHITE>(b, p, ctx) - bishop_terms<chess::BLACK>(b, p, ctx);
+        });
+        time([&](const Board& b, const EvalContext& ctx) {
+            return rook_terms<chess::WHITE>(b, p, ctx) - rook_terms<chess::BLACK>(b, p, ctx);
+        });
+        time([&](const Board& b, const EvalContext& ctx) {
+            return queen_terms<chess::WHITE>(b, p, ctx) - queen_terms<chess::BLACK>(b, p, ctx);
+        });
+        time([&](const Board& b, const EvalContext& ctx) {
+            return king_safety<chess::WHITE>(b, p, ctx) - king_safety<chess::BLACK>(b, p, ctx);
+        });
+        time([&](const Board& b, const EvalContext&) {
+            return king_activity<chess::WHITE>(b, p) - king_activity<chess::BLACK>(b, p);
+        });
+        time([&](const Board& b, const EvalContext&) {
+            EvalContext ctx;
+            build_context(b, p, ctx);
+            return chess::Score(ctx.king_attack_weight[chess::WHITE], ctx.king_attack_weight[chess::BLACK]);
+        });
+        time([&](const Board& b, const EvalContext&) {
+            return chess::Score(evaluate_with<false>(b, p, nullptr), 0);
+        });
     }
 
-    // King Safty
-    eval::TaperedScore white_king_safety = king_safety_score(b, chess::Color::WHITE);
-    eval::TaperedScore black_king_safety = king_safety_score(b, chess::Color::BLACK);
-    mg_score += white_king_safety.mg - black_king_safety.mg;
-    eg_score += white_king_safety.eg - black_king_safety.eg;
-
-    // King Activity
-    eval::TaperedScore white_king_activity = king_activity_score(b, chess::Color::WHITE);
-    eval::TaperedScore black_king_activity = king_activity_score(b, chess::Color::BLACK);
-    mg_score += white_king_activity.mg - black_king_activity.mg;
-    eg_score += white_king_activity.eg - black_king_activity.eg;
+    const double count = double(positions.size()) * runs;
+    for (TermCost& cost : costs) {
+        cost.ns /= count;
+        cost.cycles /= count;
+    }
+    static volatile uint32_t result;
+    result = result + sink;
+    return costs;
 }
-
-int Search::evaluate(const Board& b) {
-    int mg_score = 0;
-    int eg_score = 0;
-
-    pawn_evaluation(b, mg_score, eg_score);
-    // std::cout << "Pawn Eval: " << mg_score << " (MG), " << eg_score << " (EG)" << std::endl;
-    knight_evaluation(b, mg_score, eg_score);
-    // std::cout << "Knight Eval: " << mg_score << " (MG), " << eg_score << " (EG)" << std::endl;
-    bishop_evaluation(b, mg_score, eg_score);
-    // std::cout << "Bishop Eval: " << mg_score << " (MG), " << eg_score << " (EG)" << std::endl;
-    rook_evaluation(b, mg_score, eg_score);
-    // std::cout << "Rook Eval: " << mg_score << " (MG), " << eg_score << " (EG)" << std::endl;
-    queen_evaluation(b, mg_score, eg_score);
-    // std::cout << "Queen Eval: " << mg_score << " (MG), " << eg_score << " (EG)" << std::endl;
-    king_evaluation(b, mg_score, eg_score);
-    // std::cout << "King Eval: " << mg_score << " (MG), " << eg_score << " (EG)" << std::endl;
-
-    int final_score = (mg_score * b.game_phase + eg_score * (util::TOTAL_PHASE - b.game_phase)) / util::TOTAL_PHASE;
-
-    // return final_score;
-    return b.white_to_move ? final_score : -final_score;
-
-}
\ No newline at end of file
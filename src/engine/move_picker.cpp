@@ -0,0 +1,280 @@
+#include "engine/move_picker.h"
+#include "engine/search.h"
+#include <algorithm>
+
+const int see_piece_vals[7] = {
+    0,     // NO_PIECE_TYPE
+    100,   // PAWN
+    320,   // KNIGHT
+    330,   // BISHOP
+    500,   // ROOK
+    900,   // QUEEN
+    10000  // KING
+};
+
+MovePicker::MovePicker(const Board& B, int ply, const SearchWorker& t, chess::Move tt)
+    : board(B), worker(&t), tt_move(tt), stage(TT_MOVE)
+{
+    killers[0] = t.killer_moves[ply][0];
+    killers[1] = t.killer_moves[ply][1];
+}
+
+MovePicker::MovePicker(const Board& B, chess::Move tt, bool checks)
+    : board(B), worker(nullptr), tt_move(tt), stage(QS_TT_MOVE), quiet_checks(checks)
+{
+}
+
+bool MovePicker::is_special(const chess::Move& move) const {
+    return move.m == tt_move.m || move.m == killers[0].m || move.m == killers[1].m;
+}
+
+// Swap the highest scored move in [begin, end) to begin and return it
+static chess::ScoredMove& pick_best(chess::MoveList& moves, size_t begin, size_t end) {
+    size_t best = begin;
+    for (size_t i = begin + 1; i < end; ++i) {
+        if (moves[i].score > moves[best].score) best = i;
+    }
+    std::swap(moves[begin], moves[best]);
+    return moves[begin];
+}
+
+// Stable insertion sort, descending. Cheap when most scores are equal, which is
+// the common case for quiet moves.
+static void insertion_sort(chess::MoveList& moves, size_t begin, size_t end) {
+    for (size_t i = begin + 1; i < end; ++i) {
+        chess::ScoredMove tmp = moves[i];
+        size_t j = i;
+        for (; j > begin && moves[j - 1].score < tmp.score; --j) {
+            moves[j] = moves[j - 1];
+        }
+        moves[j] = tmp;
+    }
+}
+
+chess::Move MovePicker::get_next_move() {
+    switch (stage) {
+    case TT_MOVE:
+        stage = GEN_CAPTURES;
+        if (MoveGen::is_legal(board, tt_move)) return tt_move;
+        [[fallthrough]];
+
+    case GEN_CAPTURES:
+        generate_captures();
+        stage = GOOD_CAPTURES;
+        [[fallthrough]];
+
+    case GOOD_CAPTURES:
+        while (current_move < end_captures) {
+            const chess::ScoredMove& m = pick_best(moveList, current_move, end_captures);
+            // Everything left loses material, try it after the quiets
+            if (m.score < 0) break;
+            ++current_move;
+            if (m.m != tt_move.m) return m;
+        }
+        bad_captures_begin = current_move;
+        stage = KILLER_1;
+        [[fallthrough]];
+
+    case KILLER_1:
+        stage = KILLER_2;
+        if (killers[0].m != tt_move.m && MoveGen::is_legal(board, killers[0])) return killers[0];
+        [[fallthrough]];
+
+    case KILLER_2:
+        stage = GEN_QUIETS;
+        if (killers[1].m != tt_move.m && killers[1].m != killers[0].m && MoveGen::is_legal(board, killers[1])) return killers[1];
+        [[fallthrough]];
+
+    case GEN_QUIETS:
+        MoveGen::init(board, moveList, MoveGen::QUIETS, true);
+        for (size_t i = end_captures; i < moveList.size(); ++i) {
+            moveList[i].score = worker->history_scores[board.board_array[moveList[i].from()]][moveList[i].to()];
+        }
+        insertion_sort(moveList, end_captures, moveList.size());
+        current_move = end_captures;
+        stage = QUIETS;
+        [[fallthrough]];
+
+    case QUIETS:
+        while (current_move < moveList.size()) {
+            const chess::ScoredMove& m = moveList[current_move++];
+            if (!is_special(m)) return m;
+        }
+        current_move = bad_captures_begin;
+        stage = BAD_CAPTURES;
+        [[fallthrough]];
+
+    case BAD_CAPTURES:
+        while (current_move < end_captures) {
+            const chess::ScoredMove& m = pick_best(moveList, current_move, end_captures);
+            ++current_move;
+            if (m.m != tt_move.m) return m;
+        }
+        stage = DONE;
+        [[fallthrough]];
+
+    case DONE:
+        break;
+
+    case QS_TT_MOVE:
+        stage = QS_GEN_CAPTURES;
+        if (MoveGen::is_legal(board, tt_move)) {
+            if (tt_move.flags() & (chess::FLAG_CAPTURE | chess::FLAG_PROMO | chess::FLAG_EP)) return tt_move;
+            if (quiet_checks && board.gives_check(tt_move)) return tt_move;
+        }
+        [[fallthrough]];
+
+    case QS_GEN_CAPTURES:
+        generate_captures();
+        stage = QS_CAPTURES;
+        [[fallthrough]];
+
+    case QS_CAPTURES:
+        while (current_move < end_captures) {
+            const chess::ScoredMove& m = pick_best(moveList, current_move, end_captures);
+            // Losing captures are never searched in qsearch
+            if (m.score < 0) break;
+            ++current_move;
+            if (m.m != tt_move.m) return m;
+        }
+        if (!quiet_checks) {
+            stage = DONE;
+            break;
+        }
+        stage = QS_GEN_CHECKS;
+        [[fallthrough]];
+
+    case QS_GEN_CHECKS:
+        MoveGen::generate_quiet_checks(board, moveList, board.compute_check_info());
+        current_move = end_captures;
+        stage = QS_CHECKS;
+        [[fallthrough]];
+
+    case QS_CHECKS:
+        while (current_move < moveList.size()) {
+            const chess::ScoredMove& m = moveList[current_move++];
+            if (m.m != tt_move.m) return m;
+        }
+        stage = DONE;
+        break;
+    }
+    return {};
+}
+
+void MovePicker::generate_captures() {
+    MoveGen::init(board, moveList, MoveGen::CAPTURES, true);
+    end_captures = moveList.size();
+    for (auto& m : moveList) {
+        m.score = (int)see(board, m);
+    }
+}
+
+
+static chess::Piece get_least_valuable_attacker(const Board& b, chess::Square sq, chess::Color side, uint64_t all_attackers, uint64_t occupied) {
+    
+    const bool is_white = (side == chess::WHITE);
+
+    // 1. Pawns
+    uint64_t pawn_attackers = chess::PawnAttacks[is_white ? chess::BLACK : chess::WHITE][sq] 
+                            & b.bitboard[chess::make_piece(side, chess::PAWN)] & all_attackers;
+    if (pawn_attackers) {
+        return chess::make_piece(side, chess::PAWN);
+    }
+
+    // 2. Knights
+    uint64_t knight_attackers = chess::KnightAttacks[sq] 
+                              & b.bitboard[chess::make_piece(side, chess::KNIGHT)] & all_attackers;
+    if (knight_attackers) {
+        return chess::make_piece(side, chess::KNIGHT);
+    }
+
+    // 3. Bishops
+    uint64_t bishop_attackers = chess::get_diagonal_slider_attacks(sq, occupied) 
+                              & b.bitboard[chess::make_piece(side, chess::BISHOP)] & all_attackers;
+    if (bishop_attackers) {
+        return chess::make_piece(side, chess::BISHOP);
+    }
+
+    // 4. Rooks
+    uint64_t rook_attackers = chess::get_orthogonal_slider_attacks(sq, occupied) 
+                            & b.bitboard[chess::make_piece(side, chess::ROOK)] & all_attackers;
+    if (rook_attackers) {
+        return chess::make_piece(side, chess::ROOK);
+    }
+
+    // 5. Queens
+    uint64_t queen_attackers = (chess::get_diagonal_slider_attacks(sq, occupied) | chess::get_orthogonal_slider_attacks(sq, occupied)) 
+                             & b.bitboard[chess::make_piece(side, chess::QUEEN)] & all_attackers;
+    if (queen_attackers) {
+        return chess::make_piece(side, chess::QUEEN);
+    }
+
+    // 6. King
+    uint64_t king_attackers = chess::KingAttacks[sq] 
+                            & b.bitboard[chess::make_piece(side, chess::KING)] & all_attackers;
+    if (king_attackers) {
+        return chess::make_piece(side, chess::KING);
+    }
+    
+    return chess::NO_PIECE;
+}
+
+
+int64_t MovePicker::see(const Board& board, chess::Move move) {
+    int64_t gain[32]; 
+    int d = 0;        
+
+    const chess::Square from_sq = (chess::Square)move.from();
+    const chess::Square to_sq = (chess::Square)move.to();
+    
+    chess::Piece moving_piece = board.board_array[from_sq];
+    chess::Piece captured_piece = (move.flags() & chess::FLAG_EP) ? 
+        (board.white_to_move ? chess::BP : chess::WP) : 
+        board.board_array[to_sq];
+
+    if (move.flags() & chess::FLAG_PROMO) {
+        moving_piece = (chess::Piece)move.promo();
+    }
+
+    else if (move.flags() == chess::FLAG_PROMO) {
+         captured_piece = chess::NO_PIECE;
+    }
+
+    uint64_t all_attackers = board.attackers_to(to_sq, true) | board.attackers_to(to_sq, false);
+    uint64_t occupied = board.occupied;
+
+    gain[d] = see_piece_vals[chess::type_of(captured_piece)];
+    chess::Color side = board.white_to_move ? chess::BLACK : chess::WHITE;
+
+    occupied ^= (ONE << from_sq); 
+    all_attackers &= occupied;     
+
+    chess::Piece last_capturing_piece = moving_piece;
+
+    while (true) {
+        d++; 
+        chess::Piece attacker_piece = get_least_valuable_attacker(board, to_sq, side, all_attackers, occupied);
+        
+        if (attacker_piece == chess::NO_PIECE) {
+            break; 
+        }
+        
+        gain[d] = see_piece_vals[chess::type_of(last_capturing_piece)] - gain[d-1];
+
+        uint64_t attacker_bb = board.bitboard[attacker_piece] & all_attackers;
+        chess::Square attacker_from_sq = util::lsb(attacker_bb);
+        
+        occupied ^= (ONE << attacker_from_sq); 
+        all_attackers &= occupied;     
+        
+        last_capturing_piece = attacker_piece;
+        side = (side == chess::WHITE) ? chess::BLACK : chess::WHITE;
+    }
+
+    // Correct unroll loop
+    while (--d > 0) {
+        gain[d-1] = -std::max(-gain[d-1], gain[d]);
+    }
+
+    return gain[0];
+}
\ No newline at end of file
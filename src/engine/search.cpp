@@ -1,14 +1,117 @@
 #include "engine/search.h"
 #include "chess/movegen.h"
-#include "engine/move_orderer.h"
+#include "engine/move_picker.h"
+#include "engine/tablebase.h"
 #include "utils/threadpool.h"
 #include <vector>
 #include <algorithm>
 
-Search::Search(size_t s): nodes_searched(0), TT(s), stopSearch(false), pool(std::max(1u, std::thread::hardware_concurrency())) { }
+Search::Search(size_t s): nodes_searched(0), TT(s), stopSearch(false) {
+    set_threads(1);
+}
+
+void Search::set_threads(size_t n) {
+    n = std::max<size_t>(1, n);
+    // Join the old helpers before their SearchWorker goes away
+    pool.reset();
+    workers.clear();
+    for (size_t i = 0; i < n; ++i) {
+        workers.push_back(std::make_unique<SearchWorker>());
+        workers.back()->id = (int)i;
+    }
+    pool = std::make_unique<ThreadPool>(n - 1);
+}
+
+uint64_t Search::nodes() const {
+    uint64_t total = 0;
+    for (const auto& worker : workers) total += worker->nodes.load(std::memory_order_relaxed);
+    return total;
+}
+
+int Search::seldepth() const {
+    int depth = 0;
+    for (const auto& worker : workers) depth = std::max(depth, worker->seldepth.load(std::memory_order_relaxed));
+    return depth;
+}
+
+uint64_t Search::pawn_probes() const {
+    uint64_t total = 0;
+    for (const auto& worker : workers) total += worker->pawn_table.probes;
+    return total;
+}
+
+uint64_t Search::pawn_hits() const {
+    uint64_t total = 0;
+    for (const auto& worker : workers) total += worker->pawn_table.hits;
+    return total;
+}
+
+void Search::clear_pawn_tables() {
+    for (auto& worker : workers) worker->pawn_table.clear();
+}
+
+PerfCounts Search::perf_total() const {
+    PerfCounts total;
+    for (const auto& worker : workers) total += worker->perf_total;
+    return total;
+}
+
+void Search::clear() {
+    TT.clear();
+    for (auto& worker : workers) {
+        worker->pawn_table.clear();
+        std::fill(&worker->killer_moves[0][0], &worker->killer_moves[0][0] + MAX_PLY * 2, chess::Move{});
+        std::fill(&worker->history_scores[0][0], &worker->history_scores[0][0] + 15 * 64, 0);
+    }
+}
+
+uint64_t Search::qsearch_evals() const {
+    uint64_t total = 0;
+    for (const auto& worker : workers) total += worker->qsearch_evals;
+    return total;
+}
+
+uint64_t Search::lazy_evals() const {
+    uint64_t total = 0;
+    for (const auto& worker : workers) total += worker->lazy_evals;
+    return total;
+}
 
-void move_to_front(std::vector<chess::Move>& moves, const chess::Move& move_to_find) {
-    auto it = std::find_if(moves.begin(), moves.end(), [&](const chess::Move& m) { return m.m == move_to_find.m; });
+uint64_t Search::tb_hits() const {
+    uint64_t total = 0;
+    for (const auto& worker : workers) total += worker->tb_hits;
+    return total;
+}
+
+int64_t Search::elapsed_ms() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - searchStartTime).count();
+}
+
+uint64_t Search::nps() const {
+    return nodes() * 1000 / std::max<int64_t>(1, elapsed_ms());
+}
+
+void Search::start_timer() {
+    timer_done = false;
+    timer = std::thread([this] {
+        std::unique_lock<std::mutex> lock(timer_mutex);
+        if (!timer_cv.wait_until(lock, searchEndTime, [this] { return timer_done; })) {
+            stopSearch.store(true, std::memory_order_relaxed);
+        }
+    });
+}
+
+void Search::stop_timer() {
+    {
+        std::lock_guard<std::mutex> lock(timer_mutex);
+        timer_done = true;
+    }
+    timer_cv.notify_one();
+    timer.join();
+}
+
+void move_to_front(chess::MoveList& moves, const chess::Move& move_to_find) {
+    auto it = std::find_if(moves.begin(), moves.end(), [&](const chess::ScoredMove& m) { return m.m == move_to_find.m; });
     if (it != moves.end()) {
         std::rotate(moves.begin(), it, it + 1);
     }
@@ -16,7 +119,25 @@ void move_to_front(std::vector<chess::Move>& moves, const chess::Move& move_to_f
 
 chess::Move Search::start_search(Board& board, int depth, int movetime, int wtime, int btime, int winc, int binc) {    
     stopSearch.store(false);
-    TT.clear();
+
+    // Tablebase positions are played straight from the DTM tables
+    chess::Move tb_move;
+    tb::Probe tb_result;
+    if (tb::probe_root(board, tb_move, tb_result)) {
+        if (!quiet) {
+            std::cout << "info depth 1 score ";
+            if (tb_result.wdl == tb::WDL_WIN) std::cout << "mate " << (tb_result.plies + 1) / 2;
+            else if (tb_result.wdl == tb::WDL_LOSS) std::cout << "mate -" << tb_result.plies / 2;
+            else std::cout << "cp 0";
+            std::cout << " nodes 0 tbhits 1 pv " << util::move_to_string(tb_move) << std::endl;
+        }
+        nodes_searched = 0;
+        best_score = tb_result.wdl == tb::WDL_WIN ? TB_WIN_EVAL : tb_result.wdl == tb::WDL_LOSS ? -TB_WIN_EVAL : DRAW_EVAL;
+        return tb_move;
+    }
+
+    // Keep the table across moves, older entries are aged out by generation
+    TT.new_search();
 
     // for (int i = 0; i < 15; ++i) {
     //     for (int j = 0; j < 64; ++j) {
@@ -25,6 +146,7 @@ chess::Move Search::start_search(Board& board, int depth, int movetime, int wtim
     // }
     int time_for_move_ms;
     auto now = std::chrono::steady_clock::now();
+    searchStartTime = now;
 
     if (movetime > 0) {
         // A fixed time search was requested.
@@ -45,7 +167,7 @@ chess::Move Search::start_search(Board& board, int depth, int movetime, int wtim
         if (phase > 0.05) time_for_move_ms = std::min(time_for_move_ms, 8000); // cap 8 sec max
         else time_for_move_ms = std::min(time_for_move_ms, 15000); // cap 15 sec max
 
-        std::cout << "phase: " << phase << " " << " time_for_move in seconds: " << (double)((time_for_move_ms*1.0)/1000) << "\n";
+        if (!quiet) std::cout << "phase: " << phase << " " << " time_for_move in seconds: " << (double)((time_for_move_ms*1.0)/1000) << "\n";
 
         if (remaining_time < 3 * 60 * 1000) {
             time_for_move_ms = 3000;
@@ -61,17 +183,82 @@ chess::Move Search::start_search(Board& board, int depth, int movetime, int wtim
         searchEndTime = std::chrono::steady_clock::now() + std::chrono::seconds(5); 
     }
     
+    for (auto& worker : workers) worker->reset(board);
+    start_timer();
+
+    // Lazy SMP: helpers search the same root independently and share results
+    // only through the TT. The calling thread drives thread 0.
+    std::vector<std::future<void>> helpers;
+    for (size_t t = 1; t < workers.size(); ++t) {
+        helpers.push_back(pool->enqueue(&Search::iterative_deepening, this, std::ref(*workers[t]), depth));
+    }
+    iterative_deepening(*workers[0], depth);
+
+    stopSearch.store(true);
+    for (auto& h : helpers) h.get();
+    stop_timer();
+    nodes_searched = nodes();
+
+    // Thread 0 reported its iterations as it went
+    if (perf_counters && !quiet) {
+        for (const auto& worker : workers) {
+            if (!worker->perf_total.available) continue;
+            for (size_t d = 0; worker->id != 0 && d < worker->perf_depths.size(); ++d) {
+                std::cout << "info string perf thread " << worker->id << " depth " << worker->perf_depths[d].depth
+                          << " " << worker->perf_depths[d].counts.format() << "\n";
+            }
+            std::cout << "info string perf thread " << worker->id << " total " << worker->perf_total.format() << "\n";
+        }
+        std::cout << std::flush;
+    }
+
+    // Prefer the deepest completed iteration, then the higher score
+    const SearchWorker* best = workers[0].get();
+    for (const auto& worker : workers) {
+        if (worker->best_move.is_null()) continue;
+        if (worker->completed_depth > best->completed_depth
+            || (worker->completed_depth == best->completed_depth && worker->best_score > best->best_score)) {
+            best = worker.get();
+        }
+    }
+    if (best != workers[0].get() && !quiet) {
+        std::cout << "info string best move from thread " << best->id << " depth " << best->completed_depth << std::endl;
+    }
+
+    best_score = best->best_score;
+    return best->best_move;
+}
+
+// Helper workers skip depths in a staggered pattern, so at any time the
+// workers are spread over a couple of different iterations.
+static const int SkipSize[]  = { 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4 };
+static const int SkipPhase[] = { 0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7 };
+
+void Search::iterative_deepening(SearchWorker& worker, int max_depth) {
+    Board& board = worker.board;
+    const bool main_thread = (worker.id == 0);
+
     chess::Move best_move_overall{};
     int64_t last_score = 0;
 
-    for (int i = 1; i <= 60; ++i) {
+    // Opened on the searching thread, so each worker counts its own events only
+    std::unique_ptr<PerfCounters> counters;
+    PerfCounts counted;
+    if (perf_counters) {
+        counters = std::make_unique<PerfCounters>();
+        if (counters->available()) counted = counters->read();
+        else counters.reset();
+    }
+
+    for (int i = 1; i <= std::min(max_depth, 60); ++i) {
 
-        if (std::chrono::steady_clock::now() >= searchEndTime) {
-            break;
+        if (stopSearch.load()) break;
+
+        if (!main_thread) {
+            const int k = (worker.id - 1) % 20;
+            if (((i + SkipPhase[k]) / SkipSize[k]) % 2) continue;
         }
 
-        nodes_searched = 0;
-        
         int64_t alpha, beta;
         if (i > 4) {
             int64_t delta = 50;
@@ -83,8 +270,8 @@ chess::Move Search::start_search(Board& board, int depth, int movetime, int wtim
         }
 
         while(true) {
-            std::vector<chess::Move> moveList;
-            MoveGen::init(board, moveList, false);
+            chess::MoveList moveList;
+            MoveGen::init(board, moveList, MoveGen::ALL, true);
             if (!best_move_overall.is_null()) {
                 move_to_front(moveList, best_move_overall);
             }
@@ -92,40 +279,29 @@ chess::Move Search::start_search(Board& board, int depth, int movetime, int wtim
             int64_t current_alpha = alpha;
             chess::Move best_move_this_iter{};
 
-            if (!moveList.empty()) {
-                chess::Move m = moveList[0];
+            for (const auto& m : moveList) {
                 board.make_move(m);
-                if (board.is_position_legal()) {
-                    int64_t s = -negamax(board, i - 1, 1, -beta, -current_alpha);
-                    if (s > current_alpha) {
-                        current_alpha = s;
-                        best_move_this_iter = m;
+                int64_t s;
+                if (best_move_this_iter.is_null()) {
+                    s = -negamax(worker, i - 1, 1, -beta, -current_alpha);
+                } else {
+                    // PVS at the root: null window first, re-search if it beats alpha
+                    s = -negamax(worker, i - 1, 1, -current_alpha - 1, -current_alpha);
+                    if (s > current_alpha && s < beta) {
+                        s = -negamax(worker, i - 1, 1, -beta, -current_alpha);
                     }
                 }
                 board.unmake_move(m);
-            }
-            if (stopSearch.load()) break;
-
-            std::vector<std::pair<std::future<int64_t>, chess::Move>> futures;
-            for (size_t j = 1; j < moveList.size(); ++j) {
-                Board b_copy = board;
-                b_copy.make_move(moveList[j]);
-                if (!b_copy.is_position_legal()) continue;
-                futures.push_back({pool.enqueue(&Search::negamax, this, b_copy, i - 1, 1, -beta, -current_alpha), moveList[j]});
-            }
-            
-            for (auto& [future, move] : futures) {
                 if (stopSearch.load()) break;
-                int64_t s = -future.get();
 
                 if (s > current_alpha) {
                     current_alpha = s;
-                    best_move_this_iter = move;
+                    best_move_this_iter = m;
+                    worker.update_pv(0, m);
+                    if (current_alpha >= beta) break;
                 }
-
-                // std::cout << s << ": " << util::move_to_string(move) << '\n';
             }
-            
+
             if (stopSearch.load()) break;
 
             if (current_alpha <= alpha) { // Fail-low
@@ -146,12 +322,37 @@ chess::Move Search::start_search(Board& board, int depth, int movetime, int wtim
             break; 
         }
 
-        std::cout << "info depth " << i << " score cp " << last_score
-        << " nodes " << nodes_searched << " pv " << util::move_to_string(best_move_overall) << std::endl;
+        if (stopSearch.load()) break;
+
+        worker.completed_depth = i;
+        worker.best_score = last_score;
+        worker.best_move = best_move_overall;
 
+        if (main_thread && !quiet) {
+            std::cout << "info depth " << i << " seldepth " << seldepth() << " score cp " << last_score
+            << " nodes " << nodes() << " nps " << nps() << " time " << elapsed_ms() << " pv";
+            for (int p = 0; p < worker.stack[0].pv_length; ++p) std::cout << " " << util::move_to_string(worker.stack[0].pv[p]);
+            std::cout << std::endl;
+        }
 
-        if (stopSearch.load()) break;
+        if (counters) {
+            const PerfCounts now = counters->read();
+            worker.perf_depths.push_back({i, now - counted});
+            counted = now;
+            if (main_thread && !quiet) {
+                std::cout << "info string perf thread 0 depth " << i << " " << worker.perf_depths.back().counts.format() << std::endl;
+            }
+        }
     }
-    
-    return best_move_overall;
-}
\ No newline at end of file
+    if (counters) worker.perf_total = counters->read();
+
+    // A stopped first iteration still has a move to play
+    if (worker.best_move.is_null()) {
+        worker.best_move = best_move_overall;
+        if (worker.best_move.is_null()) {
+            chess::MoveList moveList;
+            MoveGen::init(board, moveList, MoveGen::ALL, true);
+            if (!moveList.empty()) worker.best_move = moveList[0];
+        }
+    }
+}
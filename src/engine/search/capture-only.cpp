@@ -1,18 +1,23 @@
 #include "engine/search.h"
 #include "chess/movegen.h"
-#include "engine/move_orderer.h"
+#include "engine/move_picker.h"
+#include "chess/nnue.h"
+#include <algorithm>
 
 
-int64_t Search::search_captures_only(Board& board, int ply, int64_t alpha, int64_t beta)
-{   
-    // if((ply & 1024) && std::chrono::steady_clock::now() >= searchEndTime) stopSearch.store(true);
-
-    // if(stopSearch.load()) return DRAW_EVAL;
+int64_t Search::search_captures_only(SearchWorker& worker, int ply, int64_t alpha, int64_t beta, bool quiet_checks)
+{
+    Board& board = worker.board;
+    // A qsearch explosion must not overrun the deadline either
+    if(stopSearch.load(std::memory_order_relaxed)) return DRAW_EVAL;
 
     TTEntry entry{};
     int64_t og_alpha = alpha;
+    chess::Move tt_move{};
 
     if(TT.probe(board.zobrist_key, entry)){
+        entry.score = score_from_tt(entry.score, ply);
+        tt_move = entry.best_move;
         if(entry.depth > 0)
         {
             //we only care about exact nodes for Qsearch to avoid bad cutoffs
@@ -22,41 +27,47 @@ int64_t Search::search_captures_only(Board& board, int ply, int64_t alpha, int64
         if(alpha >= beta) return entry.score;
     }
 
-    nodes_searched++;
-    int64_t score = evaluate(board);
-    if(score >= beta) return beta;
-    if(score > alpha) alpha = score;
+    worker.count_node();
+    worker.update_seldepth(ply);
+    // Reuse the static eval from the TT entry when there is one
+    int16_t static_eval = entry.eval;
+    if(static_eval == TTEntry::NO_EVAL)
+    {
+        ++worker.qsearch_evals;
+        // Lazy stand pat: far enough outside the window, the terms beyond material
+        // and PSTs cannot bring the score back into it. The lazy score is never
+        // stored as the static eval, so the TT only ever holds full evaluations.
+        bool lazy = false;
+        if(lazy_eval_margin > 0 && !nnue::enabled())
+        {
+            const int lazy_score = lazy_evaluate(board);
+            if(lazy_score - lazy_eval_margin >= beta){
+                ++worker.lazy_evals;
+                return beta;
+            }
+            lazy = (lazy_score + lazy_eval_margin <= alpha);
+            worker.lazy_evals += lazy;
+        }
+        if(!lazy) static_eval = (int16_t)std::clamp(evaluate(board, &worker.pawn_table), -32000, 32000);
+    }
+    if(static_eval != TTEntry::NO_EVAL)
+    {
+        // Stand pat
+        if(static_eval >= beta) return beta;
+        if(static_eval > alpha) alpha = static_eval;
+    }
 
-    MoveOrderer orderer(board, ply, *this, false);
+    // Only captures and promotions with SEE >= 0, plus quiet checks when asked for
+    MovePicker picker(board, tt_move, quiet_checks && qsearch_checks);
     chess::Move move{};
     chess::Move best_move{};
 
-    while(!(move = orderer.get_next_move()).is_null())
+    while(!(move = picker.get_next_move()).is_null())
     {
-        bool checkOrCapture = false;
         board.make_move(move);
-        
-        if(!board.is_position_legal()){
-            board.unmake_move(move);
-            continue;
-        }
-
-        if(move.flags() == chess::FLAG_CAPTURE || move.flags() == chess::FLAG_CAPTURE_PROMO || move.flags() == chess::FLAG_EP) checkOrCapture = true;
-        if (checkOrCapture && orderer.see(board, move) < 0) {
-            board.unmake_move(move);
-            continue; 
-        }
-
-        chess::Square opp_king_sq = (board.white_to_move) ? board.black_king_sq : board.white_king_sq;
-        if(board.square_attacked(opp_king_sq, board.white_to_move)) checkOrCapture = true;
-
-        if(!checkOrCapture){
-            board.unmake_move(move);
-            continue;
-        }
-        
-        score = -search_captures_only(board, ply+1, -beta, -alpha);
+        int64_t score = -search_captures_only(worker, ply+1, -beta, -alpha, false);
         board.unmake_move(move);
+        if(stopSearch.load(std::memory_order_relaxed)) return DRAW_EVAL;
 
         //Cutoffs deliberately not stored in the Transposition table here to avoid polluting the table
         if(score >= beta) return beta;
@@ -66,7 +77,9 @@ int64_t Search::search_captures_only(Board& board, int ply, int64_t alpha, int64
         }
     }
 
-    entry = { board.zobrist_key, 0, alpha, TTEntry::EXACT, best_move };
+    // Nothing raised alpha: the score is only an upper bound
+    const TTEntry::Bound bound = (alpha > og_alpha) ? TTEntry::EXACT : TTEntry::UPPER_BOUND;
+    entry = { board.zobrist_key, 0, score_to_tt(alpha, ply), bound, best_move, static_eval };
     TT.store(entry);
 
     return alpha;
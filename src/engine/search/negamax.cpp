@@ -1,17 +1,18 @@
 #include "engine/search.h"
 #include "chess/movegen.h"
-#include "engine/move_orderer.h"
+#include "engine/move_picker.h"
+#include "engine/tablebase.h"
 
 
-int64_t Search::negamax(Board& board, int depth, int ply, int64_t alpha, int64_t beta)
+int64_t Search::negamax(SearchWorker& worker, int depth, int ply, int64_t alpha, int64_t beta)
 {
-    if ((nodes_searched & 1024) == 0 && std::chrono::steady_clock::now() >= searchEndTime) {
-            stopSearch.store(true);
-        }
+    Board& board = worker.board;
+    worker.stack[ply].pv_length = 0;
 
-    if ((nodes_searched & 1024) == 0 && stopSearch.load()) {
-        return DRAW_EVAL;
-    }
+    // The timer thread and UCI "stop" set the flag; a relaxed load is all a node pays
+    if (stopSearch.load(std::memory_order_relaxed)) return DRAW_EVAL;
+
+    if (ply >= MAX_PLY - 1) return evaluate(board, &worker.pawn_table);
 
     if(ply > 0)
     {
@@ -25,6 +26,16 @@ int64_t Search::negamax(Board& board, int depth, int ply, int64_t alpha, int64_t
             if(board.zobrist_key == board.undo_stack[start_index].zobrist_before) ++rep_count;
             if(rep_count >= 2) return DRAW_EVAL; 
         }
+
+        // Tablebase positions are scored exactly, without searching them
+        tb::WDL wdl;
+        if(util::count_bits(board.occupied) <= tb::max_pieces() && tb::probe_wdl(board, wdl))
+        {
+            ++worker.tb_hits;
+            if(wdl == tb::WDL_WIN) return TB_WIN_EVAL - ply;
+            if(wdl == tb::WDL_LOSS) return -TB_WIN_EVAL + ply;
+            return DRAW_EVAL;
+        }
     }
 
     if (board.checks) {
@@ -36,6 +47,7 @@ int64_t Search::negamax(Board& board, int depth, int ply, int64_t alpha, int64_t
     chess::Move best_move_from_tt; // Store TT move
 
     if(TT.probe(board.zobrist_key, entry)){
+        entry.score = score_from_tt(entry.score, ply);
         if(entry.depth >= depth)
         {
             if(entry.bound == TTEntry::EXACT) return entry.score;
@@ -49,7 +61,7 @@ int64_t Search::negamax(Board& board, int depth, int ply, int64_t alpha, int64_t
     if (!board.checks && ply > 0 && depth > 2 && (board.white_to_move ? board.material_white > 3000 : board.material_black > 3000)) {
         int R = 3;
         board.make_move({});
-        int64_t null_score = -negamax(board, depth - 1 - R, ply + 1, -beta, -beta + 1);
+        int64_t null_score = -negamax(worker, depth - 1 - R, ply + 1, -beta, -beta + 1);
         board.unmake_move({}); 
 
         if (null_score >= beta) {
@@ -57,34 +69,31 @@ int64_t Search::negamax(Board& board, int depth, int ply, int64_t alpha, int64_t
         }
     }
 
-    nodes_searched++;    
-    if (depth == 0) {
-        return search_captures_only(board, ply, alpha, beta);
+    worker.count_node();
+    worker.update_seldepth(ply);
+    // Null-move reductions can overshoot depth 0
+    if (depth <= 0) {
+        return search_captures_only(worker, ply, alpha, beta, true);
     }
     
-    // Orderer will use best_move_from_tt if it's valid
-    MoveOrderer orderer(board, ply, *this, false);
+    // Picker tries best_move_from_tt first if it is legal here
+    MovePicker picker(board, ply, worker, best_move_from_tt);
     chess::Move move;
     chess::Move best_move = best_move_from_tt; // Initialize with TT move
 
     int legal_moves_found = 0;
     
-    while(!(move = orderer.get_next_move()).is_null()){
-        if(stopSearch.load()) return DRAW_EVAL;
+    while(!(move = picker.get_next_move()).is_null()){
+        if(stopSearch.load(std::memory_order_relaxed)) return DRAW_EVAL;
 
         board.make_move(move);
-        if(!board.is_position_legal()){
-            board.unmake_move(move);
-            continue;
-        }
-        
         legal_moves_found++;
         int64_t score;
 
         // --- CORRECT PVS (Principal Variation Search) ---
         if (legal_moves_found == 1) {
             // 1. First Move (PV): Search with the full window.
-            score = -negamax(board, depth - 1, ply + 1, -beta, -alpha);
+            score = -negamax(worker, depth - 1, ply + 1, -beta, -alpha);
         
         } else {
             // 2. Subsequent Moves: Assume they are worse. Search with a "null window".
@@ -96,25 +105,27 @@ int64_t Search::negamax(Board& board, int depth, int ply, int64_t alpha, int64_t
             }
             // ---------------------------------
 
-            score = -negamax(board, depth - 1 - reduction, ply + 1, -alpha - 1, -alpha);
+            score = -negamax(worker, depth - 1 - reduction, ply + 1, -alpha - 1, -alpha);
 
             // 3. Re-search: If the null window failed high, re-search with the full window.
             if (score > alpha && score < beta) {
-                score = -negamax(board, depth - 1, ply + 1, -beta, -alpha);
+                score = -negamax(worker, depth - 1, ply + 1, -beta, -alpha);
             }
         }
         // --- END PVS ---
 
         board.unmake_move(move);
+        // An aborted child returned DRAW_EVAL, not a score: store nothing from this node
+        if (stopSearch.load(std::memory_order_relaxed)) return DRAW_EVAL;
 
         if (score >= beta) {
             if(move.flags() != chess::FLAG_CAPTURE && move.flags() != chess::FLAG_CAPTURE_PROMO && move.flags() != chess::FLAG_EP && move.flags() != chess::FLAG_PROMO) 
             {
-                update_killers(ply, move);
-                // update_history(board, move, depth);
+                update_killers(worker, ply, move);
+                // update_history(worker, move, depth);
             }
 
-            entry = { board.zobrist_key, (uint8_t)depth, score, TTEntry::LOWER_BOUND, move };
+            entry = { board.zobrist_key, (uint8_t)depth, score_to_tt(score, ply), TTEntry::LOWER_BOUND, move };
             TT.store(entry);
 
             return beta; 
@@ -122,19 +133,20 @@ int64_t Search::negamax(Board& board, int depth, int ply, int64_t alpha, int64_t
         if (score > alpha) {
             best_move = move; // This is our new best move in this node
             alpha = score; 
+            worker.update_pv(ply, move);
         }
     }
     
     if (legal_moves_found == 0) {
         int64_t final_score = board.checks ? (CHECKMATE_EVAL + ply) : DRAW_EVAL;
-        entry = { board.zobrist_key, (int8_t)MAX_PLY, final_score, TTEntry::EXACT, {} };
+        entry = { board.zobrist_key, (int8_t)MAX_PLY, score_to_tt(final_score, ply), TTEntry::EXACT, {} };
         TT.store(entry);
         return final_score;
     }
     
     TTEntry::Bound bound = (alpha <= og_alpha) ? TTEntry::UPPER_BOUND : TTEntry::EXACT;
 
-    entry = { board.zobrist_key, (uint8_t)depth, alpha, bound, best_move };
+    entry = { board.zobrist_key, (uint8_t)depth, score_to_tt(alpha, ply), bound, best_move };
     TT.store(entry);
 
     return alpha;
@@ -0,0 +1,328 @@
+#include "engine/tablebase.h"
+#include "chess/bitboard.h"
+#include "chess/movegen.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <unordered_map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace tb {
+
+namespace {
+
+// Squares under the board symmetries: bit 2 transposes, bit 1 flips the ranks,
+// bit 0 the files. Tables with pawns only use the file flip.
+std::array<std::array<uint8_t, 64>, 8> make_symmetries() {
+    std::array<std::array<uint8_t, 64>, 8> table{};
+    for (int s = 0; s < 8; ++s) {
+        for (int sq = 0; sq < 64; ++sq) {
+            int t = (s & 4) ? ((sq & 7) << 3 | sq >> 3) : sq;
+            if (s & 2) t ^= 56;
+            if (s & 1) t ^= 7;
+            table[s][sq] = uint8_t(t);
+        }
+    }
+    return table;
+}
+const auto SYMMETRY = make_symmetries();
+
+// White king squares of canonical placements: a1-d1-d4 without pawns, files
+// a-d with them. FOLD maps a square to its slot (-1 off the region), UNFOLD back.
+struct KingFold {
+    int8_t fold[64];
+    uint8_t unfold[32];
+    int count = 0;
+};
+KingFold make_fold(bool pawns) {
+    KingFold k{};
+    for (int sq = 0; sq < 64; ++sq) {
+        const int file = sq & 7, rank = sq >> 3;
+        const bool in = pawns ? file < 4 : (file < 4 && rank <= file);
+        k.fold[sq] = in ? int8_t(k.count) : int8_t(-1);
+        if (in) k.unfold[k.count++] = uint8_t(sq);
+    }
+    return k;
+}
+const KingFold PAWNLESS_FOLD = make_fold(false);
+const KingFold PAWN_FOLD = make_fold(true);
+
+inline uint64_t flip_key(uint64_t key) { return key >> 32 | key << 32; } // black's nibbles sit 32 bits above white's
+
+struct Mapping {
+    void* address;
+    size_t length;
+};
+
+std::unordered_map<uint64_t, std::unique_ptr<Table>> tables;
+std::vector<Mapping> mappings;
+
+const char PIECE_LETTERS[] = " PNBRQK";
+
+// Maps a table file and checks its header; returns the data past the header
+const uint8_t* map_file(const std::string& path, uint32_t kind, uint64_t positions, std::string& error) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = "cannot open " + path;
+        return nullptr;
+    }
+    struct stat st;
+    const uint64_t data = kind == 0 ? positions : (positions + 3) / 4;
+    if (fstat(fd, &st) != 0 || uint64_t(st.st_size) != 16 + data) {
+        ::close(fd);
+        error = path + " has the wrong size";
+        return nullptr;
+    }
+    void* address = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        error = "cannot map " + path;
+        return nullptr;
+    }
+    const uint32_t* header = static_cast<const uint32_t*>(address);
+    if (header[0] != MAGIC || header[1] != VERSION || header[2] != kind || header[3] != positions) {
+        munmap(address, size_t(st.st_size));
+        error = path + " is not a tablebase file of this version";
+        return nullptr;
+    }
+    mappings.push_back({address, size_t(st.st_size)});
+    return static_cast<const uint8_t*>(address) + 16;
+}
+
+// Castling and en-passant captures are outside the tables
+bool probeable(const Board& b) {
+    if (b.castle_rights != chess::NO_CASTLING) return false;
+    if (b.en_passant_sq == chess::SQUARE_NONE) return true;
+    const chess::Color us = b.white_to_move ? chess::WHITE : chess::BLACK;
+    const uint64_t pawns = b.bitboard[chess::make_piece(us, chess::PAWN)];
+    return !(chess::PawnAttacks[~us][b.en_passant_sq] & pawns);
+}
+
+} // namespace
+
+int loaded_pieces = 0;
+
+uint64_t material_key(const Board& b) {
+    uint64_t key = 0;
+    for (int p = chess::WP; p <= chess::BK; ++p) {
+        if (p == chess::WK + 1) p = chess::BP;
+        key += uint64_t(util::count_bits(b.bitboard[p])) << (4 * p);
+    }
+    return key;
+}
+
+bool describe(const std::string& name, Table& table) {
+    const size_t second_king = name.find('K', 1);
+    if (name.size() < 3 || name[0] != 'K' || second_king == std::string::npos) return false;
+    table = Table{};
+    table.name = name;
+    table.key = uint64_t(1) << (4 * chess::WK) | uint64_t(1) << (4 * chess::BK);
+    for (size_t i = 1; i < name.size(); ++i) {
+        if (i == second_king) continue;
+        const char* letter = std::strchr(PIECE_LETTERS + 1, name[i]);
+        if (!letter || *letter == 'K' || !*letter) return false;
+        const chess::Color colour = i < second_king ? chess::WHITE : chess::BLACK;
+        const chess::Piece piece = chess::make_piece(colour, chess::PieceType(letter - PIECE_LETTERS));
+        table.pieces.push_back(piece);
+        table.pawns |= chess::type_of(piece) == chess::PAWN;
+        table.key += uint64_t(1) << (4 * piece);
+    }
+    const int count = 2 + int(table.pieces.size());
+    if (count < 3 || count > MAX_PIECES) return false;
+    const uint64_t kings = table.pawns ? PAWN_FOLD.count : PAWNLESS_FOLD.count;
+    table.size = 2 * (kings << (6 * (count - 1)));
+    return true;
+}
+
+std::vector<std::string> all_tables(int max_pieces) {
+    // Strongest piece first on each side, the stronger side as white
+    const std::string order = "QRBNP";
+    std::vector<std::string> names;
+    for (size_t a = 0; a < order.size(); ++a) names.push_back(std::string("K") + order[a] + "K");
+    if (max_pieces >= 4) {
+        for (size_t a = 0; a < order.size(); ++a) {
+            for (size_t b = a; b < order.size(); ++b) {
+                names.push_back(std::string("K") + order[a] + order[b] + "K");
+                names.push_back(std::string("K") + order[a] + "K" + order[b]);
+            }
+        }
+    }
+    // Captures only lead to smaller tables and promotions to tables with fewer pawns
+    auto rank = [](const std::string& name) {
+        return std::make_pair(name.size(), std::count(name.begin(), name.end(), 'P'));
+    };
+    std::stable_sort(names.begin(), names.end(), [&](const std::string& x, const std::string& y) { return rank(x) < rank(y); });
+    return names;
+}
+
+uint64_t index_of(const Table& table, const Placement& p) {
+    const int count = 2 + int(table.pieces.size());
+    const bool twins = count == 4 && table.pieces[0] == table.pieces[1];
+    const int symmetries = table.pawns ? 2 : 8;
+    uint64_t best = ~uint64_t(0);
+    for (int s = 0; s < symmetries; ++s) {
+        int sq[MAX_PIECES];
+        for (int i = 0; i < count; ++i) sq[i] = SYMMETRY[s][p.squares[i]];
+        if (twins && sq[2] > sq[3]) std::swap(sq[2], sq[3]); // identical pieces: one order only
+        uint64_t key = 0;
+        for (int i = 0; i < count; ++i) key = key << 6 | uint64_t(sq[i]);
+        best = std::min(best, key);
+    }
+    // The smallest image has its white king in the folded region
+    const int rest_bits = 6 * (count - 1);
+    const KingFold& fold = table.pawns ? PAWN_FOLD : PAWNLESS_FOLD;
+    const uint64_t king_slot = uint64_t(!p.white_to_move) * fold.count + uint64_t(fold.fold[best >> rest_bits]);
+    return king_slot << rest_bits | (best & ((uint64_t(1) << rest_bits) - 1));
+}
+
+Placement placement_of(const Table& table, uint64_t index) {
+    const int count = 2 + int(table.pieces.size());
+    const KingFold& fold = table.pawns ? PAWN_FOLD : PAWNLESS_FOLD;
+    Placement p{};
+    for (int i = count - 1; i >= 1; --i) {
+        p.squares[i] = chess::Square(index & 63);
+        index >>= 6;
+    }
+    p.white_to_move = index < uint64_t(fold.count);
+    p.squares[0] = chess::Square(fold.unfold[index % fold.count]);
+    return p;
+}
+
+bool placement_in(const Table& table, const Board& b, Placement& p) {
+    const uint64_t key = material_key(b);
+    if (key != table.key && flip_key(key) != table.key) return false;
+    const bool flipped = key != table.key;
+    auto square = [flipped](int sq) { return chess::Square(flipped ? sq ^ 56 : sq); };
+
+    p.squares[0] = square(flipped ? b.black_king_sq : b.white_king_sq);
+    p.squares[1] = square(flipped ? b.white_king_sq : b.black_king_sq);
+    uint64_t taken = 0; // the first of two identical pieces
+    for (size_t i = 0; i < table.pieces.size(); ++i) {
+        const chess::Piece piece = flipped ? chess::Piece(table.pieces[i] ^ 8) : table.pieces[i];
+        const chess::Square sq = util::lsb(b.bitboard[piece] & ~taken);
+        taken |= uint64_t(1) << sq;
+        p.squares[2 + i] = square(sq);
+    }
+    p.white_to_move = b.white_to_move != flipped;
+    return true;
+}
+
+const Table* find(const Board& b, Placement& p) {
+    const uint64_t key = material_key(b);
+    auto it = tables.find(key);
+    if (it == tables.end()) it = tables.find(flip_key(key));
+    if (it == tables.end()) return nullptr;
+    placement_in(*it->second, b, p);
+    return it->second.get();
+}
+
+bool load_table(const std::string& dir, const std::string& name, std::string& error) {
+    auto table = std::make_unique<Table>();
+    if (!describe(name, *table)) {
+        error = name + " is not a 3- or 4-man table";
+        return false;
+    }
+    const std::string base = (std::filesystem::path(dir) / name).string();
+    table->dtm = map_file(base + ".dtm", 0, table->size, error);
+    table->wdl = table->dtm ? map_file(base + ".wdl", 1, table->size, error) : nullptr;
+    if (!table->wdl) return false;
+    loaded_pieces = std::max(loaded_pieces, 2 + int(table->pieces.size()));
+    const uint64_t key = table->key;
+    tables[key] = std::move(table);
+    return true;
+}
+
+bool load(const std::string& dir, std::string& error) {
+    unload();
+    std::error_code ec;
+    std::filesystem::directory_iterator it(dir, ec);
+    if (ec) {
+        error = "cannot read " + dir;
+        return false;
+    }
+    for (const auto& entry : it) {
+        if (entry.path().extension() != ".dtm") continue;
+        std::string table_error;
+        // A bad file only costs its own table
+        if (!load_table(dir, entry.path().stem().string(), table_error)) error = table_error;
+    }
+    return true;
+}
+
+void unload() {
+    tables.clear();
+    for (const Mapping& m : mappings) munmap(m.address, m.length);
+    mappings.clear();
+    loaded_pieces = 0;
+}
+
+size_t tables_loaded() { return tables.size(); }
+
+bool probe_wdl(const Board& b, WDL& result) {
+    if (util::count_bits(b.occupied) == 2) {
+        result = WDL_DRAW;
+        return true;
+    }
+    Placement p;
+    const Table* table = find(b, p);
+    if (!table || !probeable(b)) return false;
+    const uint64_t index = index_of(*table, p);
+    const int code = (table->wdl[index >> 2] >> (2 * (index & 3))) & 3;
+    result = code == 2 ? WDL_WIN : code == 1 ? WDL_LOSS : WDL_DRAW;
+    return true;
+}
+
+bool probe_dtm(const Board& b, Probe& result) {
+    result = Probe{};
+    if (util::count_bits(b.occupied) == 2) return true;
+    Placement p;
+    const Table* table = find(b, p);
+    if (!table || !probeable(b)) return false;
+    const uint8_t dtm = table->dtm[index_of(*table, p)];
+    if (dtm != DTM_DRAW) {
+        result.wdl = (dtm & 1) ? WDL_WIN : WDL_LOSS;
+        result.plies = dtm;
+    }
+    return true;
+}
+
+bool probe_root(Board& b, chess::Move& move, Probe& result) {
+    Probe root;
+    if (loaded_pieces == 0 || !probe_dtm(b, root)) return false;
+    chess::MoveList moves;
+    MoveGen::init(b, moves, MoveGen::ALL, true);
+    if (moves.empty()) return false;
+
+    // Ranked by the outcome for us: a mate sooner, a loss later
+    auto rank = [](const Probe& child) {
+        if (child.wdl == WDL_LOSS) return 1000 - child.plies;
+        if (child.wdl == WDL_WIN) return -1000 + child.plies;
+        return 0;
+    };
+    bool found = false;
+    int best = 0;
+    Probe best_child;
+    for (const chess::Move& m : moves) {
+        b.make_move(m);
+        Probe child;
+        const bool ok = probe_dtm(b, child);
+        b.unmake_move(m);
+        if (!ok) return false;
+        if (!found || rank(child) > best) {
+            found = true;
+            best = rank(child);
+            best_child = child;
+            move = m;
+        }
+    }
+    result.wdl = WDL(-best_child.wdl);
+    result.plies = best_child.wdl == WDL_DRAW ? 0 : best_child.plies + 1;
+    return true;
+}
+
+} // namespace tb
@@ -0,0 +1,383 @@
+#include "engine/tablebase.h"
+#include "chess/bitboard.h"
+#include "chess/movegen.h"
+#include "utils/threadpool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <mutex>
+
+// Retrograde generation of one table. Every legal position starts with the
+// count of its distinct successors inside the table; moves that leave it
+// (captures, promotions) are looked up in the loaded tables. Then, one mate
+// distance at a time, the positions resolved at that distance are un-moved:
+// the predecessors of a loss become wins one ply longer, and a predecessor
+// whose successors all turn out to be wins becomes a loss. What is left at
+// the end is drawn.
+//
+// A double step the opponent can answer en passant leads to a position the
+// table does not index: the same placement with the capture added. Its value is
+// the better, for the side to move there, of the indexed placement and the best
+// en-passant capture, which leaves the table and is probed.
+namespace tb {
+
+namespace {
+
+constexpr uint8_t UNKNOWN = 254;
+constexpr uint8_t INVALID = 253;
+constexpr uint8_t NO_EXIT = 255;
+
+// DTM bytes that are resolved, and won or lost for the side to move
+bool wins(uint8_t v) { return v < INVALID && (v & 1); }
+bool loses(uint8_t v) { return v < INVALID && !(v & 1); }
+
+// A double step from `from` to `to` the opponent can answer en passant; ep is
+// their best capture as a DTM byte for them
+struct EnPassant {
+    uint64_t to, from;
+    uint8_t ep;
+    bool operator<(const EnPassant& other) const { return to != other.to ? to < other.to : from < other.from; }
+};
+
+class Generator {
+public:
+    Generator(const Table& t, size_t threads)
+        : table(t), count(2 + int(t.pieces.size())), threads(std::max<size_t>(1, threads)), pool(this->threads),
+          value(new std::atomic<uint8_t>[t.size]), successors(new std::atomic<uint8_t>[t.size]),
+          exit_win(new uint8_t[t.size]), exit_loss(new uint8_t[t.size]) {}
+
+    bool run(std::string& error) {
+        parallel([this](uint64_t begin, uint64_t end) {
+            Board board;
+            for (uint64_t i = begin; i < end; ++i) initialise(i, board);
+        });
+        std::sort(en_passant.begin(), en_passant.end());
+        if (missing.load()) {
+            error = table.name + " needs the tables its captures and promotions lead to";
+            return false;
+        }
+        for (int plies = 0; plies <= highest.load(); ++plies) {
+            // A mate through a capture or promotion counts once nothing shorter was found
+            if (plies & 1) {
+                parallel([this, plies](uint64_t begin, uint64_t end) {
+                    for (uint64_t i = begin; i < end; ++i) {
+                        if (exit_win[i] == plies && value[i].load(std::memory_order_relaxed) == UNKNOWN) value[i].store(uint8_t(plies), std::memory_order_relaxed);
+                    }
+                });
+            }
+            resolve_en_passant(plies);
+            parallel([this, plies](uint64_t begin, uint64_t end) {
+                for (uint64_t i = begin; i < end; ++i) {
+                    if (value[i].load(std::memory_order_relaxed) == plies) retract(i, plies);
+                }
+            });
+        }
+        return true;
+    }
+
+    // Final DTM bytes; invalid and unresolved positions become draws
+    uint8_t result(uint64_t i) const {
+        const uint8_t v = value[i].load(std::memory_order_relaxed);
+        return v == UNKNOWN || v == INVALID ? DTM_DRAW : v;
+    }
+    bool legal(uint64_t i) const { return value[i].load(std::memory_order_relaxed) != INVALID; }
+
+private:
+    // Splits the index range into blocks the pool picks up one at a time
+    template <typename F>
+    void parallel(F work) {
+        const uint64_t block = 1 << 14;
+        std::atomic<uint64_t> next{0};
+        std::vector<std::future<void>> tasks;
+        for (size_t t = 0; t < threads; ++t) {
+            tasks.push_back(pool.enqueue([&] {
+                uint64_t begin;
+                while ((begin = next.fetch_add(block)) < table.size) work(begin, std::min(begin + block, table.size));
+            }));
+        }
+        for (auto& task : tasks) task.get();
+    }
+
+    chess::Piece piece(int i) const {
+        return i == 0 ? chess::WK : i == 1 ? chess::BK : table.pieces[i - 2];
+    }
+
+    // Distinct squares, no pawn on the back ranks, and the canonical image
+    bool well_formed(const Placement& p, uint64_t index) const {
+        uint64_t seen = 0;
+        for (int i = 0; i < count; ++i) {
+            const uint64_t bit = uint64_t(1) << p.squares[i];
+            if (seen & bit) return false;
+            seen |= bit;
+            const int rank = p.squares[i] >> 3;
+            if (chess::type_of(piece(i)) == chess::PAWN && (rank == 0 || rank == 7)) return false;
+        }
+        return index_of(table, p) == index;
+    }
+
+    void set_up(Board& board, const Placement& p) const {
+        board.clear();
+        for (int i = 0; i < count; ++i) {
+            board.board_array[p.squares[i]] = piece(i);
+            util::set_bit(board.bitboard[piece(i)], p.squares[i]);
+        }
+        board.white_to_move = p.white_to_move;
+        board.finish_setup();
+    }
+
+    void raise_highest(int plies) {
+        int seen = highest.load(std::memory_order_relaxed);
+        while (plies > seen && !highest.compare_exchange_weak(seen, plies, std::memory_order_relaxed)) {}
+    }
+
+    void initialise(uint64_t i, Board& board) {
+        exit_win[i] = NO_EXIT;
+        exit_loss[i] = 0;
+        successors[i].store(0, std::memory_order_relaxed);
+        const Placement p = placement_of(table, i);
+        if (!well_formed(p, i)) {
+            value[i].store(INVALID, std::memory_order_relaxed);
+            return;
+        }
+        set_up(board, p);
+        // The side that just moved must not be in check
+        const chess::Square their_king = board.white_to_move ? board.black_king_sq : board.white_king_sq;
+        if (board.square_attacked(their_king, board.white_to_move)) {
+            value[i].store(INVALID, std::memory_order_relaxed);
+            return;
+        }
+
+        chess::MoveList moves;
+        MoveGen::init(board, moves, MoveGen::ALL, true);
+        if (moves.empty()) {
+            value[i].store(board.checks ? 0 : DTM_DRAW, std::memory_order_relaxed);
+            return;
+        }
+
+        uint64_t inside[chess::MAX_MOVES];
+        int n = 0;
+        bool exit_draw = false;
+        for (const chess::Move& m : moves) {
+            board.make_move(m);
+            Placement child;
+            Probe probe;
+            if (placement_in(table, board, child)) {
+                inside[n++] = index_of(table, child);
+                uint8_t ep = DTM_DRAW;
+                if ((m.flags() & chess::FLAG_DOUBLE_PUSH) && en_passant_value(board, ep)) {
+                    if (ep != DTM_DRAW) raise_highest(ep + 1);
+                    std::lock_guard<std::mutex> lock(en_passant_mutex);
+                    en_passant.push_back({inside[n - 1], i, ep});
+                }
+            } else if (!probe_dtm(board, probe)) {
+                missing.store(true, std::memory_order_relaxed);
+            } else if (probe.wdl == WDL_LOSS) {
+                exit_win[i] = uint8_t(std::min<int>(exit_win[i], probe.plies + 1));
+            } else if (probe.wdl == WDL_WIN) {
+                exit_loss[i] = uint8_t(std::max<int>(exit_loss[i], probe.plies + 1));
+            } else {
+                exit_draw = true;
+            }
+            board.unmake_move(m);
+        }
+        // Symmetric moves can reach the same canonical successor
+        std::sort(inside, inside + n);
+        n = int(std::unique(inside, inside + n) - inside);
+        successors[i].store(uint8_t(n), std::memory_order_relaxed);
+
+        if (exit_draw) exit_loss[i] = NO_EXIT; // this position can no longer lose
+        uint8_t v = UNKNOWN;
+        if (exit_win[i] != NO_EXIT) raise_highest(exit_win[i]);
+        else if (n == 0 && !exit_draw) {
+            v = exit_loss[i]; // every move leaves the table and loses
+            raise_highest(v);
+        }
+        value[i].store(v, std::memory_order_relaxed);
+    }
+
+    // Best en-passant capture for the side to move in board, as a DTM byte for
+    // them; false when there is none
+    bool en_passant_value(Board& board, uint8_t& best) {
+        chess::MoveList captures;
+        MoveGen::init(board, captures, MoveGen::CAPTURES, true);
+        bool found = false;
+        for (const chess::Move& m : captures) {
+            if (!(m.flags() & chess::FLAG_EP)) continue;
+            board.make_move(m);
+            Probe probe;
+            if (!probe_dtm(board, probe)) missing.store(true, std::memory_order_relaxed);
+            board.unmake_move(m);
+            const uint8_t v = probe.wdl == WDL_DRAW ? DTM_DRAW : uint8_t(probe.plies + 1);
+            // The fastest win, then a draw, then the slowest loss
+            auto rank = [](uint8_t x) { return wins(x) ? 1000 - x : x == DTM_DRAW ? 500 : x; };
+            if (!found || rank(v) > rank(best)) best = v;
+            found = true;
+        }
+        return found;
+    }
+
+    // The move from `from` to `to` when it is a double step the opponent can answer en passant
+    const EnPassant* en_passant_edge(uint64_t from, uint64_t to) const {
+        const EnPassant key{to, from, 0};
+        auto it = std::lower_bound(en_passant.begin(), en_passant.end(), key);
+        return it != en_passant.end() && it->to == to && it->from == from ? &*it : nullptr;
+    }
+
+    // Results en-passant captures make due at plies, when the indexed position
+    // has not made them already: a mate through the capture counts against the
+    // double step, and a loss through it lets the double step win
+    void resolve_en_passant(int plies) {
+        for (const EnPassant& e : en_passant) {
+            const uint8_t child = value[e.to].load(std::memory_order_relaxed);
+            if (wins(e.ep) && e.ep == plies && !(wins(child) && child < plies)) successor_won(e.from, plies);
+            if (loses(e.ep) && e.ep + 1 == plies && loses(child) && child < e.ep) resolve(e.from, uint8_t(plies));
+        }
+    }
+
+    void resolve(uint64_t q, uint8_t v) {
+        uint8_t expected = UNKNOWN;
+        if (value[q].compare_exchange_strong(expected, v, std::memory_order_relaxed)) raise_highest(v);
+    }
+
+    // A successor of q turned out to win at plies for the opponent
+    void successor_won(uint64_t q, int plies) {
+        if (value[q].load(std::memory_order_relaxed) != UNKNOWN) return;
+        if (successors[q].fetch_sub(1, std::memory_order_relaxed) != 1) return;
+        // Every successor wins for the opponent; a capture or promotion may still win or draw
+        if (exit_win[q] != NO_EXIT || exit_loss[q] == NO_EXIT) return;
+        resolve(q, uint8_t(std::max<int>(plies + 1, exit_loss[q])));
+    }
+
+    // Squares the piece on sq can have come from without capturing
+    uint64_t origins(chess::Piece pc, chess::Square sq, uint64_t occupied) const {
+        const uint64_t empty = ~occupied;
+        switch (chess::type_of(pc)) {
+        case chess::KING: return chess::KingAttacks[sq] & empty;
+        case chess::KNIGHT: return chess::KnightAttacks[sq] & empty;
+        case chess::BISHOP: return chess::get_diagonal_slider_attacks(sq, occupied) & empty;
+        case chess::ROOK: return chess::get_orthogonal_slider_attacks(sq, occupied) & empty;
+        case chess::QUEEN:
+            return (chess::get_diagonal_slider_attacks(sq, occupied) | chess::get_orthogonal_slider_attacks(sq, occupied)) & empty;
+        case chess::PAWN: {
+            const bool white = chess::color_of(pc) == chess::WHITE;
+            const int back = white ? -8 : 8;
+            const int one = sq + back;
+            const int rank = sq >> 3;
+            uint64_t from = 0;
+            if ((white ? rank >= 2 : rank <= 5) && (empty >> one & 1)) {
+                from |= uint64_t(1) << one;
+                // Double step from the second rank
+                if (rank == (white ? 3 : 4) && (empty >> (one + back) & 1)) from |= uint64_t(1) << (one + back);
+            }
+            return from;
+        }
+        default: return 0;
+        }
+    }
+
+    // Passes a position resolved at plies on to its predecessors
+    void retract(uint64_t i, int plies) {
+        const Placement p = placement_of(table, i);
+        const chess::Color mover = p.white_to_move ? chess::BLACK : chess::WHITE;
+        uint64_t occupied = 0;
+        for (int k = 0; k < count; ++k) occupied |= uint64_t(1) << p.squares[k];
+
+        uint64_t before[chess::MAX_MOVES];
+        int n = 0;
+        for (int k = 0; k < count; ++k) {
+            if (chess::color_of(piece(k)) != mover) continue;
+            uint64_t from = origins(piece(k), p.squares[k], occupied);
+            while (from) {
+                Placement q = p;
+                q.squares[k] = util::pop_lsb(from);
+                q.white_to_move = !p.white_to_move;
+                const uint64_t index = index_of(table, q);
+                const bool double_step = chess::type_of(piece(k)) == chess::PAWN && std::abs(q.squares[k] - p.squares[k]) == 16;
+                const EnPassant* ep = double_step && !en_passant.empty() ? en_passant_edge(index, i) : nullptr;
+                if (!ep) before[n++] = index;
+                // The opponent's answer through the capture, when it is better for them
+                else if (!(plies & 1) && loses(ep->ep) && ep->ep <= plies) resolve(index, uint8_t(plies + 1));
+                else if ((plies & 1) && !(wins(ep->ep) && ep->ep <= plies)) successor_won(index, plies);
+            }
+        }
+
+        if (!(plies & 1)) {
+            // Moving into a loss wins
+            for (int k = 0; k < n; ++k) resolve(before[k], uint8_t(plies + 1));
+            return;
+        }
+        // Each predecessor counted this position once
+        std::sort(before, before + n);
+        n = int(std::unique(before, before + n) - before);
+        for (int k = 0; k < n; ++k) successor_won(before[k], plies);
+    }
+
+    const Table& table;
+    const int count;
+    const size_t threads;
+    ThreadPool pool;
+    std::unique_ptr<std::atomic<uint8_t>[]> value;      // DTM byte, UNKNOWN or INVALID
+    std::unique_ptr<std::atomic<uint8_t>[]> successors; // in the table and not yet known to lose for us
+    std::unique_ptr<uint8_t[]> exit_win;                // shortest mate through leaving the table
+    std::unique_ptr<uint8_t[]> exit_loss;               // longest loss through leaving it, NO_EXIT when that can draw
+    std::atomic<int> highest{0};
+    std::atomic<bool> missing{false};
+    std::vector<EnPassant> en_passant; // sorted by successor once initialised
+    std::mutex en_passant_mutex;
+};
+
+bool write_file(const std::string& path, uint32_t kind, uint64_t positions, const std::vector<uint8_t>& data, std::string& error) {
+    std::ofstream out(path, std::ios::binary);
+    const uint32_t header[4] = {MAGIC, VERSION, kind, uint32_t(positions)};
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(data.data()), std::streamsize(data.size()));
+    if (!out) {
+        error = "cannot write " + path;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+bool generate(const std::string& name, const std::string& dir, size_t threads, GenerateStats& stats, std::string& error) {
+    Table table;
+    if (!describe(name, table)) {
+        error = name + " is not a 3- or 4-man table";
+        return false;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<uint8_t> dtm(table.size), wdl((table.size + 3) / 4);
+    {
+        Generator generator(table, threads);
+        if (!generator.run(error)) return false;
+
+        stats = GenerateStats{};
+        for (uint64_t i = 0; i < table.size; ++i) {
+            dtm[i] = generator.result(i);
+            if (!generator.legal(i)) continue;
+            ++stats.positions;
+            if (dtm[i] == DTM_DRAW) {
+                ++stats.draws;
+                continue;
+            }
+            const bool win = dtm[i] & 1;
+            wdl[i >> 2] |= uint8_t((win ? 2 : 1) << (2 * (i & 3)));
+            ++(win ? stats.wins : stats.losses);
+            if (win) stats.max_plies = std::max<int>(stats.max_plies, dtm[i]);
+        }
+    }
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const std::string base = (std::filesystem::path(dir) / name).string();
+    return write_file(base + ".dtm", 0, table.size, dtm, error)
+        && write_file(base + ".wdl", 1, table.size, wdl, error)
+        && load_table(dir, name, error);
+}
+
+} // namespace tb
@@ -1,43 +1,177 @@
 #include "engine/transposition.h"
+#include <algorithm>
 #include <cstring>
+#include <thread>
+#include <vector>
 
-TranspositionTable::TranspositionTable(size_t size_mb) : locks(NumLocks)
+// ----------------- Packing -----------------
+// Move (16): from(6) | to(6) | kind(4). Kinds 0-4 are quiet, capture, en passant,
+// castle and double push. Kinds 8-15 are promotions: bit 2 marks a capture, the
+// low two bits the promoted piece type from knight to queen. Its colour follows
+// from the destination rank.
+static uint16_t pack_move(const chess::Move& move)
 {
-    num_entries = (size_mb * 1024 * 1024) / sizeof(TTEntry);
-    table = std::make_unique<TTEntry[]>(num_entries);
+    if (move.is_null()) return 0;
+
+    const uint16_t flags = move.flags();
+    uint16_t kind;
+    if (flags & chess::FLAG_PROMO) {
+        kind = 8 | ((flags & chess::FLAG_CAPTURE) ? 4 : 0) | (chess::type_of((chess::Piece)move.promo()) - chess::KNIGHT);
+    } else if (flags & chess::FLAG_EP) {
+        kind = 2;
+    } else if (flags & chess::FLAG_CASTLE) {
+        kind = 3;
+    } else if (flags & chess::FLAG_DOUBLE_PUSH) {
+        kind = 4;
+    } else {
+        kind = (flags & chess::FLAG_CAPTURE) ? 1 : 0;
+    }
+    return (uint16_t)(move.from() | (move.to() << 6) | (kind << 12));
+}
+
+static chess::Move unpack_move(uint16_t packed)
+{
+    if (packed == 0) return {};
+
+    const int from = packed & 0x3F;
+    const int to = (packed >> 6) & 0x3F;
+    const int kind = packed >> 12;
+
+    if (kind & 8) {
+        const chess::Color color = (to >= chess::A8) ? chess::WHITE : chess::BLACK;
+        const chess::PieceType pt = (chess::PieceType)(chess::KNIGHT + (kind & 3));
+        const uint16_t flags = (kind & 4) ? chess::FLAG_CAPTURE_PROMO : chess::FLAG_PROMO;
+        return chess::Move(from, to, flags, chess::make_piece(color, pt));
+    }
+
+    static const uint16_t kind_flags[5] = {
+        chess::FLAG_QUIET, chess::FLAG_CAPTURE, chess::FLAG_EP, chess::FLAG_CASTLE, chess::FLAG_DOUBLE_PUSH
+    };
+    return chess::Move(from, to, kind < 5 ? kind_flags[kind] : uint16_t(chess::FLAG_QUIET), chess::NO_PIECE);
+}
+
+static inline int16_t clamp_score(int64_t score)
+{
+    return (int16_t)std::clamp<int64_t>(score, -32000, 32000);
+}
+
+static inline uint64_t pack_data(const TTEntry& e, uint8_t generation)
+{
+    return (uint64_t)pack_move(e.best_move)
+         | ((uint64_t)(uint16_t)clamp_score(e.score) << 16)
+         | ((uint64_t)(uint16_t)e.eval << 32)
+         | ((uint64_t)e.depth << 48)
+         | ((uint64_t)(e.bound | (generation << 2)) << 56);
+}
+
+static inline uint16_t data_move(uint64_t data) { return (uint16_t)data; }
+static inline int16_t data_score(uint64_t data) { return (int16_t)(data >> 16); }
+static inline int16_t data_eval(uint64_t data) { return (int16_t)(data >> 32); }
+static inline uint8_t data_depth(uint64_t data) { return (uint8_t)(data >> 48); }
+static inline uint8_t data_bound(uint64_t data) { return (uint8_t)(data >> 56) & 0x3; }
+static inline uint8_t data_generation(uint64_t data) { return (uint8_t)(data >> 58); }
+
+
+// ----------------- Table -----------------
+TranspositionTable::TranspositionTable(size_t size_mb)
+{
+    num_clusters = std::max<size_t>(1, (size_mb * 1024 * 1024) / sizeof(Cluster));
+    table.reset(new Cluster[num_clusters]);
     clear();
 }
 
 void TranspositionTable::clear()
 {
-    std::memset(table.get(), 0, num_entries * sizeof(TTEntry));
+    // Zero the table in parallel chunks, one per hardware thread. A single
+    // memset of a large hash is bound by one core's memory bandwidth.
+    const size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    const size_t chunk = (num_clusters + threads - 1) / threads;
+
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+        const size_t begin = t * chunk;
+        if (begin >= num_clusters) break;
+        const size_t count = std::min(chunk, num_clusters - begin);
+        workers.emplace_back([this, begin, count]() {
+            std::memset(static_cast<void*>(table.get() + begin), 0, count * sizeof(Cluster));
+        });
+    }
+    for (auto& w : workers) w.join();
+
+    generation = 0;
+}
+
+void TranspositionTable::new_search()
+{
+    generation = (generation + 1) & 0x3F;
 }
 
 void TranspositionTable::store(const TTEntry& entry)
 {
-    uint64_t index = entry.key % num_entries;
-    
-    std::lock_guard<std::mutex> guard(locks[entry.key % NumLocks]);
+    Cluster& cluster = cluster_for(entry.key);
+
+    Slot* replace = &cluster.slots[0];
+    int replace_value = INT32_MAX;
+    bool same_position = false;
+    uint64_t old_data = 0;
 
-    // Replacement strategy: Always replace if the new entry is from a deeper search.
-    // Also replace if the slot is empty (key == 0) to fill the table.
-    if (entry.depth >= table[index].depth || table[index].key == 0)
-    {
-        table[index] = entry;
+    for (Slot& slot : cluster.slots) {
+        const uint64_t data = slot.data.load(std::memory_order_relaxed);
+        const uint64_t key = slot.key.load(std::memory_order_relaxed);
+
+        if ((key ^ data) == entry.key) {
+            replace = &slot;
+            same_position = true;
+            old_data = data;
+            break;
+        }
+
+        // Empty slots have depth 0 and lose to anything; older generations count as 8 plies shallower each
+        const int age = (generation - data_generation(data)) & 0x3F;
+        const int value = (data == 0 && key == 0) ? INT32_MIN : data_depth(data) - 8 * age;
+        if (value < replace_value) {
+            replace_value = value;
+            replace = &slot;
+        }
+    }
+
+    TTEntry to_store = entry;
+    if (same_position) {
+        // Keep a clearly deeper result from this search, whatever the bounds: qsearch
+        // stores at depth 0 and must not wipe out a negamax entry
+        if (data_generation(old_data) == generation && entry.depth + 4 < data_depth(old_data)) {
+            return;
+        }
+        // Do not lose the move when the new result has none
+        if (to_store.best_move.is_null()) {
+            to_store.best_move = unpack_move(data_move(old_data));
+        }
+        if (to_store.eval == TTEntry::NO_EVAL) {
+            to_store.eval = data_eval(old_data);
+        }
     }
+
+    const uint64_t data = pack_data(to_store, generation);
+    replace->key.store(entry.key ^ data, std::memory_order_relaxed);
+    replace->data.store(data, std::memory_order_relaxed);
 }
 
-bool TranspositionTable::probe(uint64_t key, TTEntry& entry)
+bool TranspositionTable::probe(uint64_t key, TTEntry& entry) const
 {
-    uint64_t index = key % num_entries;
-
-    std::lock_guard<std::mutex> guard(locks[key % NumLocks]);
+    const Cluster& cluster = cluster_for(key);
 
-    entry = table[index];
+    for (const Slot& slot : cluster.slots) {
+        const uint64_t data = slot.data.load(std::memory_order_relaxed);
+        if ((slot.key.load(std::memory_order_relaxed) ^ data) != key) continue;
 
-    if (entry.key == key) {
+        entry.key = key;
+        entry.depth = data_depth(data);
+        entry.score = data_score(data);
+        entry.bound = (TTEntry::Bound)data_bound(data);
+        entry.best_move = unpack_move(data_move(data));
+        entry.eval = data_eval(data);
         return true;
     }
-    
+
     return false;
-}
\ No newline at end of file
+}
@@ -0,0 +1,256 @@
+#include "engine/tuner.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <future>
+#include <sstream>
+
+namespace tuner {
+
+namespace {
+
+// Packed datasets start with this, text ones never do
+const char PACKED_MAGIC[8] = {'H', 'C', 'T', 'U', 'N', 'E', '0', '1'};
+
+// Values that no position can reach: pawns on the back ranks, and the empty
+// and king material entries (both sides always have exactly one king)
+bool unused(const eval::ParamField& f, int i) {
+    const int entry = i / 2;
+    if (f.name == "psts.pawn") return entry < 8 || entry >= 56;
+    if (f.name == "material_values") return entry == chess::NO_PIECE_TYPE || entry == chess::KING;
+    return false;
+}
+
+} // namespace
+
+PackedPosition pack(const Board& b, double result) {
+    PackedPosition p{};
+    for (int sq = 0; sq < 64; ++sq) p.squares[sq / 2] |= uint8_t(b.board_array[sq] << (4 * (sq & 1)));
+    p.flags = uint8_t(b.white_to_move) | uint8_t(b.castle_rights << 1);
+    p.ep = uint8_t(b.en_passant_sq);
+    p.halfmove = uint8_t(std::min<int>(b.halfmove_clock, 255));
+    p.result = uint8_t(std::lround(result * 2));
+    return p;
+}
+
+double unpack(const PackedPosition& p, Board& b) {
+    b.clear();
+    for (int sq = 0; sq < 64; ++sq) {
+        const chess::Piece piece = chess::Piece((p.squares[sq / 2] >> (4 * (sq & 1))) & 0xF);
+        if (piece == chess::NO_PIECE) continue;
+        b.board_array[sq] = piece;
+        util::set_bit(b.bitboard[piece], (chess::Square)sq);
+    }
+    b.white_to_move = p.flags & 1;
+    b.castle_rights = chess::CastlingRights((p.flags >> 1) & 0xF);
+    b.en_passant_sq = chess::Square(p.ep);
+    b.halfmove_clock = p.halfmove;
+    b.finish_setup();
+    return p.result / 2.0;
+}
+
+bool parse_result(const std::string& line, double& result) {
+    const size_t open = line.find('[');
+    if (open != std::string::npos) {
+        char* end = nullptr;
+        result = std::strtod(line.c_str() + open + 1, &end);
+        return end != line.c_str() + open + 1 && result >= 0 && result <= 1;
+    }
+    if (line.find("1/2-1/2") != std::string::npos) result = 0.5;
+    else if (line.find("1-0") != std::string::npos) result = 1;
+    else if (line.find("0-1") != std::string::npos) result = 0;
+    else return false;
+    return true;
+}
+
+std::string fen_of_line(const std::string& line) {
+    std::istringstream iss(line);
+    std::string board, side, castling, ep;
+    iss >> board >> side >> castling >> ep;
+    return board + ' ' + side + ' ' + castling + ' ' + ep + " 0 1";
+}
+
+bool pack_dataset(const std::string& in_path, const std::string& out_path, size_t& count, std::string& error) {
+    std::ifstream in(in_path);
+    if (!in) {
+        error = "cannot open " + in_path;
+        return false;
+    }
+    std::ofstream out(out_path, std::ios::binary);
+    if (!out) {
+        error = "cannot write " + out_path;
+        return false;
+    }
+    out.write(PACKED_MAGIC, sizeof(PACKED_MAGIC));
+
+    count = 0;
+    Board board;
+    std::string line;
+    double result;
+    while (std::getline(in, line)) {
+        if (!parse_result(line, result)) continue;
+        std::string fen = fen_of_line(line);
+        board.set_fen(fen);
+        const PackedPosition p = pack(board, result);
+        out.write(reinterpret_cast<const char*>(&p), sizeof(p));
+        ++count;
+    }
+    if (!out) {
+        error = "cannot write " + out_path;
+        return false;
+    }
+    return true;
+}
+
+double Chunk::load(size_t i, Board& b) const {
+    if (i < lines.size()) {
+        std::string fen = fen_of_line(lines[i]);
+        b.set_fen(fen);
+        return results[i];
+    }
+    return unpack(packed[i - lines.size()], b);
+}
+
+bool DatasetReader::open(const std::string& path, std::string& error) {
+    in.open(path, std::ios::binary);
+    if (!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+    char magic[sizeof(PACKED_MAGIC)] = {};
+    in.read(magic, sizeof(magic));
+    is_packed = in.gcount() == sizeof(magic) && std::memcmp(magic, PACKED_MAGIC, sizeof(magic)) == 0;
+    data_start = is_packed ? std::streampos(sizeof(magic)) : std::streampos(0);
+    rewind();
+    return true;
+}
+
+void DatasetReader::rewind() {
+    in.clear();
+    in.seekg(data_start);
+}
+
+bool DatasetReader::next(Chunk& chunk, size_t max) {
+    chunk.clear();
+    if (is_packed) {
+        chunk.packed.resize(max);
+        in.read(reinterpret_cast<char*>(chunk.packed.data()), std::streamsize(max * sizeof(PackedPosition)));
+        chunk.packed.resize(size_t(in.gcount()) / sizeof(PackedPosition));
+    } else {
+        std::string line;
+        double result;
+        while (chunk.lines.size() < max && std::getline(in, line)) {
+            if (!parse_result(line, result)) continue;
+            chunk.lines.push_back(line);
+            chunk.results.push_back(result);
+        }
+    }
+    return chunk.size() > 0;
+}
+
+Tuner::Tuner(const Options& opts) : options(opts), pool(std::max<size_t>(1, opts.threads)), search(16) {
+    for (size_t i = 0; i < std::max<size_t>(1, options.threads); ++i) workers.push_back(std::make_unique<SearchWorker>());
+    // Exact scores: the lazy stand pat would answer with material and PSTs only
+    search.lazy_eval_margin = 0;
+}
+
+bool Tuner::open(std::string& error) {
+    return reader.open(options.dataset, error);
+}
+
+double Tuner::slice_error(const Chunk& chunk, size_t begin, size_t end, SearchWorker& worker, double k) {
+    double total = 0;
+    for (size_t i = begin; i < end; ++i) {
+        const double result = chunk.load(i, worker.board);
+        int64_t score = options.qsearch
+            ? search.search_captures_only(worker, 0, NEG_INFINITY_EVAL, -NEG_INFINITY_EVAL, true)
+            : Search::evaluate(worker.board, &worker.pawn_table);
+        if (!worker.board.white_to_move) score = -score;
+        const double predicted = 1.0 / (1.0 + std::pow(10.0, -k * double(score) / 400.0));
+        total += (result - predicted) * (result - predicted);
+    }
+    return total;
+}
+
+double Tuner::error(double k) {
+    // Cached scores and pawn entries belong to the previous parameters
+    search.TT.clear();
+    for (auto& worker : workers) worker->pawn_table.clear();
+
+    reader.rewind();
+    Chunk chunks[2];
+    int current = 0;
+    double total = 0;
+    size_t count = 0;
+    bool more = reader.next(chunks[current], options.chunk_size);
+    while (more) {
+        const Chunk& chunk = chunks[current];
+        const size_t slices = workers.size();
+        std::vector<std::future<double>> parts;
+        for (size_t s = 0; s < slices; ++s) {
+            const size_t begin = chunk.size() * s / slices;
+            const size_t end = chunk.size() * (s + 1) / slices;
+            SearchWorker* worker = workers[s].get();
+            parts.push_back(pool.enqueue([this, &chunk, begin, end, worker, k] { return slice_error(chunk, begin, end, *worker, k); }));
+        }
+        // Read the next chunk while the pool scores this one
+        current ^= 1;
+        more = reader.next(chunks[current], options.chunk_size);
+        for (auto& part : parts) total += part.get();
+        count += chunk.size();
+    }
+    counted = count;
+    return count ? total / double(count) : 0.0;
+}
+
+double Tuner::fit_k() {
+    // Golden-section search; the error is unimodal in k
+    const double ratio = (std::sqrt(5.0) - 1) / 2;
+    double lo = 0.0, hi = 4.0;
+    double a = hi - ratio * (hi - lo), b = lo + ratio * (hi - lo);
+    double error_a = error(a), error_b = error(b);
+    while (hi - lo > 0.001) {
+        if (error_a < error_b) {
+            hi = b;
+            b = a;
+            error_b = error_a;
+            a = hi - ratio * (hi - lo);
+            error_a = error(a);
+        } else {
+            lo = a;
+            a = b;
+            error_a = error_b;
+            b = lo + ratio * (hi - lo);
+            error_b = error(b);
+        }
+    }
+    return (lo + hi) / 2;
+}
+
+size_t Tuner::local_search(eval::EvalData& params, const std::vector<std::string>& fields, double k, double& best_error) {
+    size_t changed = 0;
+    for (const eval::ParamField& f : eval::param_fields(params)) {
+        if (!fields.empty() && std::find(fields.begin(), fields.end(), f.name) == fields.end()) continue;
+        for (int i = 0; i < f.count; ++i) {
+            if (unused(f, i)) continue;
+            const int original = f[i];
+            bool improved = false;
+            for (int delta : {1, -1}) {
+                f[i] = original + delta;
+                eval::set_params(params);
+                const double e = error(k);
+                if (e < best_error) {
+                    best_error = e;
+                    improved = true;
+                    break;
+                }
+            }
+            if (improved) ++changed;
+            else f[i] = original;
+        }
+    }
+    eval::set_params(params);
+    return changed;
+}
+
+} // namespace tuner
@@ -1,12 +1,17 @@
 #include "engine/uci.h"
 #include "engine/opening_book.h"
+#include "engine/bench.h"
 #include "chess/zobrist.h"
+#include "engine/evaluate.h"
+#include "engine/tablebase.h"
+#include <algorithm>
+#include <charconv>
 
 // Helper function to find a move in the legal move list that matches a UCI move string
 // This version correctly handles promotion moves.
 chess::Move parse_move(Board& board, const std::string& move_string) {
-    std::vector<chess::Move> legal_moves;
-    MoveGen::init(board, legal_moves, false);
+    chess::MoveList legal_moves;
+    MoveGen::init(board, legal_moves, MoveGen::ALL, true);
 
     for (const auto& move : legal_moves) {
         std::string generated_move_str = util::move_to_string(move);
@@ -30,6 +35,13 @@ chess::Move parse_move(Board& board, const std::string& move_string) {
     return {}; // Return a null move if not found
 }
 
+// Reads a spin option's value; false when it is not a whole number in int's range
+bool parse_spin(const std::string& value, int& result) {
+    const char* end = value.data() + value.size();
+    const auto [ptr, ec] = std::from_chars(value.data(), end, result);
+    return ec == std::errc() && ptr == end;
+}
+
 // Function to run the search in a separate thread
 // This version correctly formats the output string for promotion moves.
 void start_search_thread(Board board, Search* search_agent, int depth, int movetime, int wtime, int btime, int winc, int binc) {
@@ -61,13 +73,88 @@ void uci(Board &board, Search& search_agent, std::thread& search_thread, Opening
         if (token == "uci") {
             std::cout << "id name Hagnus-Carlsen" << std::endl;
             std::cout << "id author Vardaan-Harshit" << std::endl;
+            std::cout << "option name Threads type spin default 1 min 1 max 256" << std::endl;
+            std::cout << "option name EvalFile type string default <empty>" << std::endl;
+            std::cout << "option name Use NNUE type check default false" << std::endl;
+            std::cout << "option name EvalParams type string default <empty>" << std::endl;
+            std::cout << "option name TablebasePath type string default <empty>" << std::endl;
+            std::cout << "option name PerfCounters type check default false" << std::endl;
+            std::cout << "option name LazyEvalMargin type spin default " << LAZY_EVAL_MARGIN << " min 0 max 5000" << std::endl;
             std::cout << "uciok" << std::endl;
         } else if (token == "isready") {
             Zobrist::init_zobrist_keys(); 
             chess::init(); // Initialize bitboards and other pre-computed data
             std::cout << "readyok" << std::endl;
+        } else if (token == "setoption") {
+            // setoption name <id> value <x>
+            std::string name, value, word;
+            iss >> word; // "name"
+            while (iss >> word && word != "value") name += (name.empty() ? "" : " ") + word;
+            std::getline(iss >> std::ws, value); // file paths may contain spaces
+
+            // Options below change state the search reads, so stop it first
+            if (search_thread.joinable()) {
+                search_agent.stopSearch.store(true);
+                search_thread.join();
+            }
+
+            int spin;
+            if (name == "Threads") {
+                if (parse_spin(value, spin)) search_agent.set_threads(std::clamp(spin, 1, 256));
+                else std::cout << "info string Threads must be a number from 1 to 256, not '" << value << "'" << std::endl;
+            } else if (name == "EvalFile") {
+                std::string error;
+                if (nnue::load(value, error)) {
+                    board.accumulators.clear(); // computed with the old weights
+                    search_agent.clear();       // and so are the static evals in the TT
+                    std::cout << "info string loaded network " << value << " (" << nnue::simd_name() << ")" << std::endl;
+                } else {
+                    std::cout << "info string " << error << std::endl;
+                }
+            } else if (name == "LazyEvalMargin") {
+                if (parse_spin(value, spin)) search_agent.lazy_eval_margin = std::clamp(spin, 0, 5000);
+                else std::cout << "info string LazyEvalMargin must be a number from 0 to 5000, not '" << value << "'" << std::endl;
+            } else if (name == "EvalParams") {
+                // Files hold only the values they change; anything else keeps its default
+                std::string error;
+                eval::EvalData params = eval::default_eval_data;
+                if (value.empty() || value == "<empty>") {
+                    eval::reset_params();
+                    std::cout << "info string using the default evaluation parameters" << std::endl;
+                } else if (eval::load_params(value, params, error)) {
+                    eval::set_params(params);
+                    std::cout << "info string loaded evaluation parameters " << value << std::endl;
+                } else {
+                    std::cout << "info string " << error << std::endl;
+                }
+                board.refresh_scores(); // psq_score was summed with the old tables
+                search_agent.clear();   // TT static evals and pawn entries too
+            } else if (name == "TablebasePath") {
+                std::string error;
+                if (value.empty() || value == "<empty>") {
+                    tb::unload();
+                } else if (tb::load(value, error)) {
+                    std::cout << "info string loaded " << tb::tables_loaded() << " tablebases, up to "
+                              << tb::max_pieces() << " pieces" << std::endl;
+                    if (!error.empty()) std::cout << "info string " << error << std::endl;
+                } else {
+                    std::cout << "info string " << error << std::endl;
+                }
+            } else if (name == "PerfCounters") {
+                search_agent.perf_counters = value == "true";
+                if (search_agent.perf_counters) {
+                    PerfCounters probe;
+                    if (probe.available()) std::cout << "info string counting " << probe.read().format() << std::endl;
+                    else std::cout << "info string no hardware counters, " << probe.error() << std::endl;
+                }
+            } else if (name == "Use NNUE") {
+                if (!nnue::set_enabled(value == "true")) {
+                    std::cout << "info string no network loaded, set EvalFile first; using the classic evaluation" << std::endl;
+                }
+                search_agent.clear(); // static evals in the TT came from the other evaluation
+            }
         } else if (token == "ucinewgame") {
-            search_agent.TT.clear(); // Clear the transposition table for a new game
+            search_agent.clear(); // TT, pawn tables, killers and history from the last game
         } else if (token == "position") {
             std::string pos_type;
             iss >> pos_type;
@@ -134,6 +221,30 @@ void uci(Board &board, Search& search_agent, std::thread& search_thread, Opening
                 search_agent.stopSearch.store(false);
                 search_thread = std::thread(start_search_thread, board, &search_agent, depth, movetime, wtime, btime, winc, binc);
             }
+        } else if (token == "bench") {
+            // bench [depth]: fixed-depth search of the built-in positions, one thread
+            int depth = bench::DEFAULT_DEPTH;
+            iss >> depth;
+            if (search_thread.joinable()) {
+                search_agent.stopSearch.store(true);
+                search_thread.join();
+            }
+            Zobrist::init_zobrist_keys();
+            chess::init();
+
+            // Its own table of the standard size, so the node count does not depend on the Hash in use
+            Search bench_search(bench::HASH_MB);
+            bench_search.lazy_eval_margin = search_agent.lazy_eval_margin;
+            bench_search.qsearch_checks = search_agent.qsearch_checks;
+            bench_search.perf_counters = search_agent.perf_counters;
+            bench::print_summary(bench::run(bench_search, std::max(1, depth), std::cout), std::cout);
+        } else if (token == "eval") {
+            // The classic evaluation of the current position, term by term
+            eval::Trace trace;
+            eval::trace(board, trace);
+            std::cout << eval::format_trace(trace);
+            if (nnue::enabled()) std::cout << "NNUE evaluation for the side to move: " << nnue::evaluate(board) << "\n";
+            std::cout << std::flush;
         } else if (token == "stop") {
             search_agent.stopSearch.store(true);
             if (search_thread.joinable()) {
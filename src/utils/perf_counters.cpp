@@ -0,0 +1,131 @@
+#include "utils/perf_counters.h"
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+const char* const PERF_EVENT_NAMES[PERF_EVENT_NB] = {
+    "cycles", "instructions", "l1d-misses", "llc-misses", "branch-misses", "dtlb-misses",
+};
+
+double PerfCounts::ipc() const {
+    if (!has(PERF_CYCLES) || !has(PERF_INSTRUCTIONS) || values[PERF_CYCLES] == 0) return 0;
+    return double(values[PERF_INSTRUCTIONS]) / values[PERF_CYCLES];
+}
+
+PerfCounts& PerfCounts::operator+=(const PerfCounts& other) {
+    available |= other.available;
+    for (int e = 0; e < PERF_EVENT_NB; ++e) values[e] += other.values[e];
+    return *this;
+}
+
+PerfCounts PerfCounts::operator-(const PerfCounts& other) const {
+    PerfCounts diff;
+    diff.available = available & other.available;
+    for (int e = 0; e < PERF_EVENT_NB; ++e) diff.values[e] = values[e] - other.values[e];
+    return diff;
+}
+
+std::string PerfCounts::format() const {
+    std::ostringstream out;
+    for (int e = 0; e < PERF_EVENT_NB; ++e) {
+        if (!has(PerfEvent(e))) continue;
+        out << (out.tellp() ? " " : "") << PERF_EVENT_NAMES[e] << " " << values[e];
+        if (e == PERF_INSTRUCTIONS && has(PERF_CYCLES)) out << " ipc " << std::fixed << std::setprecision(2) << ipc();
+    }
+    return out.str();
+}
+
+std::string PerfCounts::to_json() const {
+    std::ostringstream out;
+    out << "{";
+    for (int e = 0; e < PERF_EVENT_NB; ++e) {
+        if (!has(PerfEvent(e))) continue;
+        out << (out.tellp() > 1 ? ", " : "") << "\"" << PERF_EVENT_NAMES[e] << "\": " << values[e];
+    }
+    out << "}";
+    return out.str();
+}
+
+#ifdef __linux__
+
+static void set_event(perf_event_attr& attr, PerfEvent e) {
+    auto cache = [](uint64_t cache_id) {
+        return cache_id | PERF_COUNT_HW_CACHE_OP_READ << 8 | PERF_COUNT_HW_CACHE_RESULT_MISS << 16;
+    };
+    attr.type = PERF_TYPE_HARDWARE;
+    switch (e) {
+        case PERF_CYCLES:        attr.config = PERF_COUNT_HW_CPU_CYCLES; break;
+        case PERF_INSTRUCTIONS:  attr.config = PERF_COUNT_HW_INSTRUCTIONS; break;
+        case PERF_LLC_MISSES:    attr.config = PERF_COUNT_HW_CACHE_MISSES; break;
+        case PERF_BRANCH_MISSES: attr.config = PERF_COUNT_HW_BRANCH_MISSES; break;
+        case PERF_L1D_MISSES:    attr.type = PERF_TYPE_HW_CACHE; attr.config = cache(PERF_COUNT_HW_CACHE_L1D); break;
+        case PERF_DTLB_MISSES:   attr.type = PERF_TYPE_HW_CACHE; attr.config = cache(PERF_COUNT_HW_CACHE_DTLB); break;
+        default: break;
+    }
+}
+
+PerfCounters::PerfCounters() {
+    for (int e = 0; e < PERF_EVENT_NB; ++e) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        set_event(attr, PerfEvent(e));
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.disabled = 1;
+
+        // pid 0, cpu -1: this thread on whichever CPU it runs
+        fds[e] = int(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        if (fds[e] < 0 && open_error.empty()) open_error = std::string("perf_event_open: ") + std::strerror(errno);
+    }
+    for (int fd : fds) {
+        if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+PerfCounters::~PerfCounters() {
+    for (int fd : fds) {
+        if (fd >= 0) close(fd);
+    }
+}
+
+bool PerfCounters::available() const {
+    for (int fd : fds) {
+        if (fd >= 0) return true;
+    }
+    return false;
+}
+
+PerfCounts PerfCounters::read() const {
+    PerfCounts counts;
+    for (int e = 0; e < PERF_EVENT_NB; ++e) {
+        uint64_t data[3]; // value, time enabled, time running
+        if (fds[e] < 0 || ::read(fds[e], data, sizeof(data)) != sizeof(data)) continue;
+        counts.values[e] = data[2] == 0 ? 0 : data[2] == data[1] ? data[0] : uint64_t(double(data[0]) * data[1] / data[2]);
+        counts.available |= 1u << e;
+    }
+    return counts;
+}
+
+#else
+
+PerfCounters::PerfCounters() : open_error("hardware counters need Linux perf_event_open") {
+    for (int& fd : fds) fd = -1;
+}
+
+PerfCounters::~PerfCounters() {}
+
+bool PerfCounters::available() const { return false; }
+
+PerfCounts PerfCounters::read() const { return {}; }
+
+#endif
@@ -0,0 +1,47 @@
+// Compile using: g++ -std=c++17 -I../include -o bench_test.out bench_test.cpp ../src/chess/*.cpp ../src/chess/movegen/*.cpp ../src/utils/*.cpp ../src/engine/*.cpp ../src/engine/search/*.cpp -O3 -march=native
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "chess/board.h"
+#include "chess/zobrist.h"
+#include "engine/bench.h"
+#include "test_util.h"
+
+int main() {
+    chess::init();
+    Zobrist::init_zobrist_keys();
+    bool ok = true;
+    const int depth = 4;
+
+    Search search(bench::HASH_MB);
+    std::ostringstream log;
+    const bench::Result first = bench::run(search, depth, log);
+    uint64_t sum = 0;
+    for (const bench::PositionResult& p : first.positions) sum += p.nodes;
+    ok &= report("Every position searched", first.positions.size() == bench::POSITIONS.size() &&
+                                            bench::POSITIONS.size() >= 50 && sum == first.nodes);
+    ok &= report("One line per position", log.str().find("Position 50/") != std::string::npos &&
+                                          log.str().find("info depth") == std::string::npos);
+
+    // Earlier searches, on more threads, leave TT entries, killers and history behind
+    Board board;
+    std::string fen = "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3";
+    board.set_fen(fen);
+    search.set_threads(2);
+    search.quiet = true;
+    search.start_search(board, 6, 60 * 1000, 0, 0, 0, 0);
+
+    const bench::Result second = bench::run(search, depth, log);
+    ok &= report("Same signature after other searches", second.nodes == first.nodes);
+    ok &= report("Thread count and quiet flag restored", search.thread_count() == 2 && search.quiet);
+
+    Search other(bench::HASH_MB);
+    ok &= report("Same signature on another Search", bench::run(other, depth, log).nodes == first.nodes);
+    ok &= report("Deeper searches more", bench::run(other, depth + 1, log).nodes > first.nodes);
+
+    std::ostringstream summary;
+    bench::print_summary(first, summary);
+    ok &= report("Summary", summary.str().find("Nodes searched  : " + std::to_string(first.nodes)) != std::string::npos);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,91 @@
+// Compile using: g++ -std=c++17 -I../include -o eval_params_test.out eval_params_test.cpp ../src/chess/*.cpp ../src/chess/movegen/*.cpp ../src/engine/*.cpp ../src/engine/search/*.cpp ../src/utils/*.cpp -O3 -march=native
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "chess/board.h"
+#include "chess/zobrist.h"
+#include "engine/evaluate.h"
+#include "engine/search.h"
+#include "test_util.h"
+
+static const std::string FEN = "r4rk1/1pp2ppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10";
+
+bool same_params(eval::EvalData a, eval::EvalData b) {
+    auto fa = eval::param_fields(a);
+    auto fb = eval::param_fields(b);
+    for (size_t f = 0; f < fa.size(); ++f) {
+        for (int i = 0; i < fa[f].count; ++i) {
+            if (fa[f][i] != fb[f][i]) return false;
+        }
+    }
+    return true;
+}
+
+int evaluate_fen(std::string fen) {
+    Board board;
+    board.set_fen(fen);
+    return Search::evaluate(board);
+}
+
+int main() {
+    chess::init();
+    Zobrist::init_zobrist_keys();
+    bool ok = true;
+    std::string error;
+    const std::string path = "eval_params_test.txt";
+
+    // Saving the defaults and loading them over a different set gives the defaults back
+    eval::EvalData changed = eval::default_eval_data;
+    changed.knight_outpost_bonus = {123, 45};
+    changed.psts[chess::QUEEN][27] = {-7, 7};
+    changed.king_attack_weights[chess::ROOK] = 9;
+    bool round_trip = eval::save_params(path, eval::default_eval_data, error) && eval::load_params(path, changed, error);
+    ok &= report("Round trip", round_trip && same_params(changed, eval::default_eval_data));
+
+    // A file with one field changes only that field
+    {
+        std::ofstream out(path);
+        out << "# material only\nmaterial_values\n 0 0  80 100  320 320  330 360  500 600  1900 2000  0 0\n";
+    }
+    eval::EvalData params = eval::default_eval_data;
+    bool loaded = eval::load_params(path, params, error);
+    eval::EvalData expected = eval::default_eval_data;
+    expected.material_values[chess::QUEEN] = {1900, 2000};
+    ok &= report("Partial file", loaded && same_params(params, expected));
+
+    // Activating a set refills the psqt tables (FEN is a queen up): a board that
+    // refreshes its scores matches one set up after the change
+    const int before = evaluate_fen(FEN);
+    Board board;
+    std::string fen = FEN;
+    board.set_fen(fen);
+    eval::set_params(params);
+    board.refresh_scores();
+    const int after = evaluate_fen(FEN);
+    ok &= report("Active set", after != before && Search::evaluate(board) == after);
+
+    eval::reset_params();
+    board.refresh_scores();
+    ok &= report("Reset", evaluate_fen(FEN) == before && Search::evaluate(board) == before);
+
+    // Bad files are rejected and leave the target untouched
+    {
+        std::ofstream out(path);
+        out << "knight_outpost_bonus 10 10\nno_such_parameter 1 2\n";
+    }
+    params = eval::default_eval_data;
+    bool rejected = !eval::load_params(path, params, error) && same_params(params, eval::default_eval_data);
+    std::cout << "    " << error << std::endl;
+    {
+        std::ofstream out(path);
+        out << "pawn_chain_bonus 1 2 3\n";
+    }
+    rejected &= !eval::load_params(path, params, error);
+    std::cout << "    " << error << std::endl;
+    ok &= report("Bad files", rejected);
+
+    std::remove(path.c_str());
+    return ok ? 0 : 1;
+}
@@ -1,9 +1,15 @@
 // Compile using: g++ -std=c++17 -I../include/chess -I../include -I../include/utils -o evaluation_test.out evaluation_test.cpp ../src/chess/*.cpp ../src/chess/movegen/*.cpp ../src/utils/threadpool.cpp ../src/engine/search.cpp ../src/engine/evaluate.cpp ../src/engine/search/*.cpp -O3 -march=native -flto -funroll-loops
 
+#include <algorithm>
+#include <cctype>
 #include <iostream>
+#include <sstream>
 #include <vector>
 #include <string>
 #include "chess/board.h"
+#include "chess/movegen.h"
+#include "chess/zobrist.h"
+#include "engine/evaluate.h"
 #include "engine/search.h"
 
 // Helper function to run and display a single evaluation test
@@ -17,6 +23,9 @@ void testEvaluate(std::string fen, const std::string& description) {
         // The evaluation function in search.cpp calls get_score_from_white_perspective
         int score = Search::evaluate(board); 
         board.print_board();
+        eval::Trace trace;
+        eval::trace(board, trace);
+        std::cout << eval::format_trace(trace);
         std::cout << "    Evaluation Score: " << score << "\n";
     } catch (const std::exception& e) {
         std::cerr << "    Error evaluating position: " << e.what() << "\n";
@@ -24,6 +33,109 @@ void testEvaluate(std::string fen, const std::string& description) {
     std::cout << std::endl;
 }
 
+// The same position with the colours swapped and the board flipped vertically
+std::string mirror_fen(const std::string& fen) {
+    std::istringstream in(fen);
+    std::string placement, side, castling, ep, halfmove, fullmove;
+    in >> placement >> side >> castling >> ep >> halfmove >> fullmove;
+
+    std::vector<std::string> ranks;
+    std::string rank;
+    std::istringstream rows(placement);
+    while (std::getline(rows, rank, '/')) ranks.push_back(rank);
+    std::reverse(ranks.begin(), ranks.end());
+
+    auto swap_case = [](char c) { return (char)(std::isupper(c) ? std::tolower(c) : std::toupper(c)); };
+    std::string mirrored;
+    for (size_t i = 0; i < ranks.size(); ++i) {
+        for (char c : ranks[i]) mirrored += swap_case(c);
+        if (i + 1 < ranks.size()) mirrored += '/';
+    }
+
+    std::string rights;
+    for (char c : castling) if (std::islower(c)) rights += swap_case(c);
+    for (char c : castling) if (std::isupper(c)) rights += swap_case(c);
+    if (rights.empty()) rights = "-";
+    if (ep != "-") ep[1] = (ep[1] == '3') ? '6' : '3';
+
+    return mirrored + " " + (side == "w" ? "b" : "w") + " " + rights + " " + ep + " " + halfmove + " " + fullmove;
+}
+
+// Every term is written once for both colours, so a position and its colour
+// mirror must evaluate the same for the side to move
+uint64_t symmetry_perft(Board& board, int depth, uint64_t& mismatches) {
+    Board mirrored;
+    std::string fen = mirror_fen(board.to_fen());
+    mirrored.set_fen(fen);
+    if (Search::evaluate(board) != Search::evaluate(mirrored)) {
+        if (mismatches++ == 0) std::cout << "    First asymmetric position: " << board.to_fen() << "\n";
+    }
+    if (depth == 0) return 1;
+
+    chess::MoveList moveList;
+    MoveGen::init(board, moveList, MoveGen::ALL, true);
+    uint64_t nodes = 0;
+    for (const auto& move : moveList) {
+        board.make_move(move);
+        nodes += symmetry_perft(board, depth - 1, mismatches);
+        board.unmake_move(move);
+    }
+    return nodes;
+}
+
+bool testSymmetry(std::string fen, int depth) {
+    Board board;
+    board.set_fen(fen);
+    uint64_t mismatches = 0;
+    uint64_t nodes = symmetry_perft(board, depth, mismatches);
+    std::cout << "    " << fen << ": " << nodes << " positions, " << mismatches << " asymmetric -> "
+              << (mismatches == 0 ? "PASSED ✅" : "FAILED ❌") << "\n";
+    return mismatches == 0;
+}
+
+// The trace adds up to the evaluation, and a colour mirror swaps its columns
+uint64_t trace_perft(Board& board, int depth, uint64_t& mismatches) {
+    eval::Trace trace, mirrored_trace;
+    const int traced = eval::trace(board, trace);
+    Board mirrored;
+    std::string fen = mirror_fen(board.to_fen());
+    mirrored.set_fen(fen);
+    eval::trace(mirrored, mirrored_trace);
+
+    chess::Score sum;
+    bool swapped = trace.phase == mirrored_trace.phase;
+    for (int term = 0; term < eval::TERM_NB; ++term) {
+        sum += trace.terms[term][chess::WHITE] - trace.terms[term][chess::BLACK];
+        swapped &= trace.terms[term][chess::WHITE].value == mirrored_trace.terms[term][chess::BLACK].value;
+        swapped &= trace.terms[term][chess::BLACK].value == mirrored_trace.terms[term][chess::WHITE].value;
+    }
+    const int side = board.white_to_move ? 1 : -1;
+    if (traced != Search::evaluate(board) || side * trace.tapered(sum) != traced || !swapped) {
+        if (mismatches++ == 0) std::cout << "    First mismatched trace: " << board.to_fen() << "\n";
+    }
+    if (depth == 0) return 1;
+
+    chess::MoveList moveList;
+    MoveGen::init(board, moveList, MoveGen::ALL, true);
+    uint64_t nodes = 0;
+    for (const auto& move : moveList) {
+        board.make_move(move);
+        nodes += trace_perft(board, depth - 1, mismatches);
+        board.unmake_move(move);
+    }
+    return nodes;
+}
+
+bool testTrace(std::string fen, int depth) {
+    Board board;
+    board.set_fen(fen);
+    uint64_t mismatches = 0;
+    uint64_t nodes = trace_perft(board, depth, mismatches);
+    std::cout << "    " << fen << ": " << nodes << " positions, " << mismatches << " mismatched -> "
+              << (mismatches == 0 ? "PASSED ✅" : "FAILED ❌") << "\n";
+    return mismatches == 0;
+}
+
 // Helper to print section headers for better organization
 void printSectionHeader(const std::string& title) {
     std::cout << "\n==================================================\n";
@@ -33,6 +145,7 @@ void printSectionHeader(const std::string& title) {
 
 int main() {
     chess::init();
+    Zobrist::init_zobrist_keys();
     std::cout << "========== CHESS ENGINE EVALUATION TEST SUITE ==========\n";
 
     // ##################################################################
@@ -204,8 +317,23 @@ int main() {
         "For Testing Purposes: FEN should be handled."
     );
 
+    printSectionHeader("Colour Symmetry Tests");
+
+    bool symmetric = true;
+    symmetric &= testSymmetry("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 2);
+    symmetric &= testSymmetry("r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 2);
+    symmetric &= testSymmetry("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 3);
+    symmetric &= testSymmetry("rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 2);
+
+    printSectionHeader("Trace Tests");
+
+    bool traced = true;
+    traced &= testTrace("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 2);
+    traced &= testTrace("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 3);
+    traced &= testTrace("rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 2);
+
     printSectionHeader("End of Tests");
 
     std::cout << "\n========== ALL TESTS COMPLETED ==========\n";
-    return 0;
+    return symmetric && traced ? 0 : 1;
 }
\ No newline at end of file
@@ -0,0 +1,115 @@
+// Compile using: g++ -std=c++17 -I../include -o nnue_test.out nnue_test.cpp ../src/chess/*.cpp ../src/chess/movegen/*.cpp -O3 -march=native
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "chess/board.h"
+#include "chess/movegen.h"
+#include "chess/nnue.h"
+#include "chess/zobrist.h"
+
+// Writes a network with small random weights in the nnue.h file format
+void write_random_network(const std::string& path) {
+    std::mt19937 rng(12345);
+    std::uniform_int_distribution<int> small(-20, 20);
+    std::ofstream out(path, std::ios::binary);
+
+    const uint32_t header[4] = {nnue::MAGIC, nnue::VERSION, (uint32_t)nnue::INPUTS, (uint32_t)nnue::L1};
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    std::vector<int16_t> values((size_t)nnue::INPUTS * nnue::L1);
+    for (auto& v : values) v = (int16_t)small(rng);
+    std::vector<int16_t> biases(nnue::L1), output(2 * nnue::L1);
+    for (auto& v : biases) v = (int16_t)(small(rng) * 4);
+    for (auto& v : output) v = (int16_t)small(rng);
+    const int32_t output_bias = 100;
+
+    out.write(reinterpret_cast<const char*>(biases.data()), biases.size() * sizeof(int16_t));
+    out.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(int16_t));
+    out.write(reinterpret_cast<const char*>(output.data()), output.size() * sizeof(int16_t));
+    out.write(reinterpret_cast<const char*>(&output_bias), sizeof(output_bias));
+}
+
+// Evaluation from a freshly refreshed accumulator
+int full_evaluate(const Board& board) {
+    Board fresh;
+    std::string fen = board.to_fen();
+    fresh.set_fen(fen);
+    return nnue::evaluate(fresh);
+}
+
+// Walks the tree evaluating only every other ply, so updates have to replay
+// several moves, and compares against a full refresh
+uint64_t eval_perft(Board& board, int depth, uint64_t& mismatches) {
+    if (depth % 2 == 0 && nnue::evaluate(board) != full_evaluate(board)) {
+        if (mismatches++ == 0) std::cout << "First mismatch at " << board.to_fen() << std::endl;
+    }
+    if (depth == 0) return 1;
+
+    chess::MoveList moveList;
+    MoveGen::init(board, moveList, MoveGen::ALL, true);
+    uint64_t nodes = 0;
+    for (const auto& move : moveList) {
+        board.make_move(move);
+        nodes += eval_perft(board, depth - 1, mismatches);
+        board.unmake_move(move);
+    }
+    return nodes;
+}
+
+bool test_incremental_eval(std::string fen, int depth) {
+    std::cout << "--- Incremental NNUE Perft ---" << std::endl;
+    std::cout << "FEN: " << fen << ", depth " << depth << std::endl;
+
+    Board board;
+    board.set_fen(fen);
+
+    uint64_t mismatches = 0;
+    uint64_t nodes = eval_perft(board, depth, mismatches);
+
+    std::cout << "Nodes: " << nodes << ", Mismatches: " << mismatches << std::endl;
+    std::cout << "Result: " << (mismatches == 0 ? "PASSED ✅" : "FAILED ❌") << std::endl;
+    std::cout << "------------------------" << std::endl << std::endl;
+    return mismatches == 0;
+}
+
+int main() {
+    Zobrist::init_zobrist_keys();
+    chess::init();
+
+    const std::string path = "nnue_test_random.bin";
+    write_random_network(path);
+    std::string error;
+    bool ok = nnue::load(path, error) && nnue::set_enabled(true);
+    std::remove(path.c_str());
+    if (!ok) {
+        std::cout << "Could not load the test network: " << error << std::endl;
+        return 1;
+    }
+    std::cout << "NNUE kernels: " << nnue::simd_name() << std::endl << std::endl;
+
+    // Castling, en passant, promotions and king moves on both sides
+    bool evals_match = true;
+    evals_match &= test_incremental_eval("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 4);
+    evals_match &= test_incremental_eval("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 3);
+    evals_match &= test_incremental_eval("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 4);
+    evals_match &= test_incremental_eval("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 3);
+    evals_match &= test_incremental_eval("rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3", 3);
+
+    // Switching NNUE on with moves already on the stack rebuilds the accumulators
+    nnue::set_enabled(false);
+    Board board;
+    std::string fen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+    board.set_fen(fen);
+    chess::MoveList moveList;
+    MoveGen::init(board, moveList, MoveGen::ALL, true);
+    board.make_move(moveList[0]);
+    nnue::set_enabled(true);
+    bool rebuilt = nnue::evaluate(board) == full_evaluate(board);
+    std::cout << "Enable mid-game: " << (rebuilt ? "PASSED ✅" : "FAILED ❌") << std::endl;
+    evals_match &= rebuilt;
+
+    return evals_match ? 0 : 1;
+}
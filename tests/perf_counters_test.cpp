@@ -0,0 +1,65 @@
+// Compile using: g++ -std=c++17 -I../include -o perf_counters_test.out perf_counters_test.cpp ../src/chess/*.cpp ../src/chess/movegen/*.cpp ../src/utils/*.cpp ../src/engine/*.cpp ../src/engine/search/*.cpp -O3 -march=native
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "chess/board.h"
+#include "chess/zobrist.h"
+#include "engine/search.h"
+#include "utils/perf_counters.h"
+#include "test_util.h"
+
+int main() {
+    chess::init();
+    Zobrist::init_zobrist_keys();
+    bool ok = true;
+
+    PerfCounts a, b;
+    a.values[PERF_CYCLES] = 1000;
+    a.values[PERF_INSTRUCTIONS] = 2500;
+    a.values[PERF_BRANCH_MISSES] = 7;
+    a.available = 1u << PERF_CYCLES | 1u << PERF_INSTRUCTIONS | 1u << PERF_BRANCH_MISSES;
+    b.values[PERF_CYCLES] = 400;
+    b.values[PERF_INSTRUCTIONS] = 500;
+    b.available = 1u << PERF_CYCLES | 1u << PERF_INSTRUCTIONS;
+
+    const PerfCounts diff = a - b;
+    ok &= report("Difference", diff.values[PERF_CYCLES] == 600 && diff.values[PERF_INSTRUCTIONS] == 2000 &&
+                               !diff.has(PERF_BRANCH_MISSES) && diff.ipc() > 3.3 && diff.ipc() < 3.4);
+    PerfCounts sum;
+    sum += a;
+    sum += b;
+    ok &= report("Sum", sum.values[PERF_CYCLES] == 1400 && sum.has(PERF_BRANCH_MISSES) && sum.has(PERF_CYCLES));
+    ok &= report("Format", a.format() == "cycles 1000 instructions 2500 ipc 2.50 branch-misses 7" &&
+                           PerfCounts().format().empty());
+    ok &= report("JSON", b.to_json() == "{\"cycles\": 400, \"instructions\": 500}" && PerfCounts().to_json() == "{}");
+
+    // Counting must not change the search, whether or not this machine has counters
+    PerfCounters counters;
+    ok &= report("Counters open or say why", counters.available() || !counters.error().empty());
+
+    Board board;
+    std::string fen = "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3";
+    uint64_t nodes[2];
+    std::string output;
+    for (int counted = 0; counted < 2; ++counted) {
+        Search search(16);
+        search.perf_counters = counted;
+        board.set_fen(fen);
+        std::ostringstream sink;
+        std::streambuf* old = std::cout.rdbuf(sink.rdbuf());
+        search.start_search(board, 6, 60 * 1000, 0, 0, 0, 0);
+        std::cout.rdbuf(old);
+        nodes[counted] = search.nodes_searched;
+        if (counted) {
+            output = sink.str();
+            const bool reported = output.find("info string perf thread 0 depth 6 cycles") != std::string::npos &&
+                                  search.perf_depths(0).size() == 6 && search.perf_total().has(PERF_CYCLES);
+            const bool silent = output.find("info string perf") == std::string::npos && search.perf_depths(0).empty();
+            ok &= report(counters.available() ? "Counted per depth" : "Silent without counters",
+                         counters.available() ? reported : silent);
+        }
+    }
+    ok &= report("Same search counted", nodes[0] == nodes[1]);
+    return ok ? 0 : 1;
+}
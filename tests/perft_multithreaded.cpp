@@ -3,28 +3,26 @@
 //
 // Description:
 // This program calculates the number of legal moves from a given chess
-// position up to a certain depth. It uses a thread pool to parallelize
-// the search at the root, significantly improving performance on
+// position up to a certain depth. It uses a thread pool and a shared perft
+// hash to parallelize the count, significantly improving performance on
 // multi-core processors. The results are validated against known values
 // for several standard test positions.
 //
 // How it works:
-// 1. A ThreadPool class is implemented to manage a set of worker threads.
-// 2. The main function sets up a series of test cases (FEN strings).
-// 3. For each test, the `perft_threaded` function is called.
-// 4. `perft_threaded` generates all legal moves from the root position.
-// 5. Each of these moves, along with the resulting board state, is
-//    submitted as a task to the thread pool.
-// 6. Each worker thread takes a task and runs a recursive `perft` search
-//    for the remaining depth.
-// 7. The main thread collects the results from all tasks and sums them
-//    up to get the final node count.
+// 1. The main function sets up a series of test cases (FEN strings).
+// 2. For each test, `perft::count_parallel` splits the tree a ply at a time
+//    below the root until every thread has plenty of tasks, merging
+//    positions reached by transposition into one task.
+// 3. The worker threads of a ThreadPool claim tasks, largest first, from a
+//    shared atomic cursor, so no thread idles behind one big root move.
+// 4. Subtree counts are shared between threads through a lock-free perft
+//    hash keyed by Zobrist key and depth.
 //
 // ===================================================================
 
 
 // USE TO COMPILE
-// g++ -std=c++17 -I../include/chess -I../include/utils -o perft_multithreaded.out perft_multithreaded.cpp ../src/chess/*.cpp ../src/chess/movegen/*.cpp ../src/utils/threadpool.cpp -O3 -march=native -flto -funroll-loops
+// g++ -std=c++17 -I../include -o perft_multithreaded.out perft_multithreaded.cpp ../src/chess/*.cpp ../src/chess/movegen/*.cpp ../src/utils/threadpool.cpp -O3 -march=native -flto -funroll-loops
 
 #include <iostream>
 #include <vector>
@@ -33,86 +31,15 @@
 #include <iomanip>
 #include <cstdint>
 #include <thread>
-#include <mutex>
-#include <condition_variable>
-#include <queue>
-#include <functional>
-#include <future>
-#include <numeric>
-
-#include "board.h"
-#include "movegen.h"
-#include "types.h"
-#include "bitboard.h"
-#include "threadpool.h"
-
-
-
-// The recursive perft function executed by worker threads.
-uint64_t perft(Board& board, int depth) {
-    // Base case: If we've reached the desired depth, we've found one leaf node.
-    if (depth == 0) {
-        return 1ULL;
-    }
 
-    std::vector<chess::Move> moveList;
-    // Generate all pseudo-legal moves for the current position.
-    MoveGen::init(board, moveList, false);
-    uint64_t nodes = 0;
-    // Iterate through all generated moves
-    for (const auto& move : moveList) {
-        // Make the move on the board
-        board.make_move(move);
-
-        // After making a move, the king of the side that just moved should
-        // not be in check by the opponent. If it is, the move was illegal.
-        chess::Square king_sq = board.white_to_move
-            ? board.black_king_sq // Black just moved, check their king
-            : board.white_king_sq; // White just moved, check their king
-
-        // square_attacked checks if the opponent is attacking the king's square.
-        if (!board.square_attacked(king_sq, board.white_to_move)) {
-            nodes += perft(board, depth - 1);
-        }
+#include "chess/board.h"
+#include "chess/perft.h"
+#include "chess/types.h"
+#include "chess/bitboard.h"
+#include "chess/zobrist.h"
 
-        // Unmake the move to restore the board to its original state for the next iteration.
-        board.unmake_move(move);
-    }
-    return nodes;
-}
-
-// Top-level function to divide perft work among threads.
-uint64_t perft_threaded(Board& root_board, int depth, ThreadPool& pool) {
-    if (depth == 0) return 1ULL;
-
-    std::vector<chess::Move> moveList;
-    MoveGen::init(root_board, moveList, false);
-    std::vector<std::future<uint64_t>> futures;
-    uint64_t total_nodes = 0;
-
-    // Iterate through root moves and create tasks for the thread pool
-    for (const auto& move : moveList) {
-        Board board_copy = root_board;
-        board_copy.make_move(move);
-
-        chess::Square king_sq = board_copy.white_to_move ? board_copy.black_king_sq : board_copy.white_king_sq;
-        if (!board_copy.square_attacked(king_sq, board_copy.white_to_move)) {
-             // If the move is legal, enqueue the rest of the search.
-             // We pass board_copy by value to ensure each thread has its own instance.
-            futures.emplace_back(
-                pool.enqueue([board_copy, depth]() mutable {
-                    return perft(board_copy, depth - 1);
-                })
-            );
-        }
-    }
-
-    // Collect results from all futures
-    for (auto &future : futures) {
-        total_nodes += future.get();
-    }
-    return total_nodes;
-}
+// Size of the perft hash shared by the worker threads
+static const size_t HASH_MB = 64;
 
 int main() {
     struct TestCase {
@@ -142,13 +69,14 @@ int main() {
     };
 
     chess::init(); // Initialize attack tables once
-    
+    Zobrist::init_zobrist_keys();
+
     // Determine the optimal number of threads to use
     unsigned int num_threads = std::max(1u, std::thread::hardware_concurrency());
-    ThreadPool pool(num_threads);
+    perft::Hash hash(HASH_MB);
     std::cout << "==========================================\n";
     std::cout << "🚀 Starting Perft Test Suite\n";
-    std::cout << "   Using " << num_threads << " worker threads.\n";
+    std::cout << "   Using " << num_threads << " worker threads, " << HASH_MB << " MB hash.\n";
     std::cout << "==========================================\n\n";
 
     bool all_tests_passed = true;
@@ -166,10 +94,8 @@ int main() {
         for (size_t depth = 1; depth <= test.expected.size(); ++depth) {
             auto start_time = std::chrono::high_resolution_clock::now();
             
-            // For shallow depths, using the overhead of the thread pool isn't efficient.
-            uint64_t nodes = (depth <= 3)
-                ? perft(board, (int)depth)
-                : perft_threaded(board, (int)depth, pool);
+            // Shallow depths are split into fewer tasks, down to one when depth <= 3.
+            uint64_t nodes = perft::count_parallel(board, (int)depth, num_threads, &hash);
             
             auto end_time = std::chrono::high_resolution_clock::now();
             
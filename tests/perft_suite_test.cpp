@@ -0,0 +1,100 @@
+// Compile using: g++ -std=c++17 -I../include -o perft_suite_test.out perft_suite_test.cpp ../src/chess/*.cpp ../src/chess/movegen/*.cpp -O3 -march=native
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "chess/bitboard.h"
+#include "chess/board.h"
+#include "chess/perft.h"
+#include "chess/zobrist.h"
+#include "test_util.h"
+
+int main() {
+    chess::init();
+    Zobrist::init_zobrist_keys();
+    bool ok = true;
+    std::string error;
+
+    const std::string path = "perft_suite_test.epd";
+    {
+        std::ofstream out(path);
+        out << "# comment\n\n"
+            << "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1 ;D1 20 ;D2 400 ;D3 8902 ;D4 197281\n"
+            << "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1 ;D1 48 ;D2 2039 ;D3 97862\n"
+            << "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1 ;D2 191 ;D4 43238\n"
+            << "n1n5/PPPk4/8/8/8/8/4Kppp/5N1N w - - 0 1 ;D1 24 ;D2 496 ;D3 9483\n"
+            << "8/8/1k6/2b5/2pP4/8/5K2/8 b - d3 0 1 ;D1 15 ;D2 126 ;D3 1928\n";
+    }
+    std::vector<perft::SuiteEntry> suite;
+    ok &= report("Load suite", perft::load_suite(path, suite, error) && suite.size() == 5 && suite[0].line == 3 &&
+                               suite[0].max_depth() == 4 && suite[2].expected[0] == 0 && suite[2].expected[3] == 43238);
+
+    // Bulk counting at every listed depth, depth 0 included
+    bool counted = true;
+    for (const perft::SuiteEntry& entry : suite) {
+        Board board;
+        std::string fen = entry.fen;
+        board.set_fen(fen);
+        counted &= perft::count(board, 0) == 1;
+        for (int depth = 1; depth <= entry.max_depth(); ++depth) {
+            if (entry.expected[depth - 1] == 0) continue;
+            const uint64_t nodes = perft::count(board, depth);
+            if (nodes != entry.expected[depth - 1]) {
+                std::cout << "    line " << entry.line << " depth " << depth << ": " << nodes << std::endl;
+                counted = false;
+            }
+        }
+        counted &= board.to_fen() == entry.fen; // every move unmade
+    }
+    ok &= report("Bulk counts", counted);
+
+    // Divide: one entry per legal move, summing to the count
+    Board board;
+    std::string fen = suite[1].fen;
+    board.set_fen(fen);
+    uint64_t total = 0;
+    const std::vector<perft::Division> divisions = perft::divide(board, 3);
+    for (const perft::Division& d : divisions) total += d.nodes;
+    const std::vector<perft::Division> leaves = perft::divide(board, 1);
+    ok &= report("Divide", divisions.size() == 48 && total == 97862 && leaves.size() == 48 && leaves[0].nodes == 1);
+
+    // Hashed and parallel counts, the hash small enough to be replacing all the time
+    perft::Hash tiny(1);
+    perft::Hash shared(16);
+    bool hashed = true, parallel = true;
+    for (const perft::SuiteEntry& entry : suite) {
+        Board b;
+        std::string f = entry.fen;
+        b.set_fen(f);
+        const int depth = entry.max_depth();
+        const uint64_t expected = entry.expected[depth - 1];
+        hashed &= perft::count(b, depth, tiny) == expected && perft::count(b, depth, tiny) == expected;
+
+        perft::ParallelStats stats;
+        parallel &= perft::count_parallel(b, depth, 4, &shared, &stats) == expected;
+        parallel &= perft::count_parallel(b, depth, 3, nullptr, &stats) == expected;
+        parallel &= perft::count_parallel(b, depth, 1, nullptr) == expected;
+        parallel &= stats.tasks <= stats.positions && (depth <= 3 || stats.split_plies > 0);
+        parallel &= b.to_fen() == entry.fen;
+    }
+    ok &= report("Hashed counts", hashed);
+    ok &= report("Parallel counts", parallel);
+
+    // Transpositions at the split ply merge: 1. e3 e6 2. d3 and 1. d3 e6 2. e3 are one task
+    perft::ParallelStats stats;
+    board.set_fen(fen = suite[0].fen);
+    const uint64_t deep = perft::count_parallel(board, 6, 64, &shared, &stats);
+    ok &= report("Split transpositions", deep == 119060324 && stats.split_plies == 3 && stats.positions == 8902 &&
+                                         stats.tasks < stats.positions);
+
+    {
+        std::ofstream out(path);
+        out << "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1 ;D1 20 ;depth 2 400\n";
+    }
+    suite.clear();
+    ok &= report("Malformed suite", !perft::load_suite(path, suite, error) && error.find(":1:") != std::string::npos);
+    ok &= report("Missing suite", !perft::load_suite("no_such_suite.epd", suite, error));
+    std::remove(path.c_str());
+    return ok ? 0 : 1;
+}
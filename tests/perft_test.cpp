@@ -1,13 +1,13 @@
-// compile using : g++ -I../include/chess -o perft_test.out perft_test.cpp ../src/chess/*.cpp ../src/chess/movegen/*.cpp
+// compile using : g++ -I../include -o perft_test.out perft_test.cpp ../src/chess/*.cpp ../src/chess/movegen/*.cpp
 
 #include <iostream>
 #include <vector>
 #include <chrono>
 #include <iomanip> // For std::fixed and std::setprecision
-#include "board.h"
-#include "movegen.h"
-#include "types.h"
-#include "bitboard.h"
+#include "chess/board.h"
+#include "chess/movegen.h"
+#include "chess/types.h"
+#include "chess/bitboard.h"
 
 // Forward declaration of the main perft function
 uint64_t perft(Board& board, int depth);
@@ -19,9 +19,9 @@ uint64_t perft(Board& board, int depth) {
         return 1ULL;
     }
 
-    std::vector<chess::Move> moveList;
+    chess::MoveList moveList;
     // Generate all pseudo-legal moves for the current position.
-    MoveGen::init(board, moveList, false);
+    MoveGen::init(board, moveList, MoveGen::ALL, false);
 
     uint64_t nodes = 0;
 
@@ -0,0 +1,117 @@
+// Compile using: g++ -std=c++17 -I../include -o tablebase_kpkp_test.out tablebase_kpkp_test.cpp ../src/chess/*.cpp ../src/chess/movegen/*.cpp ../src/engine/*.cpp ../src/engine/search/*.cpp ../src/utils/*.cpp -O3 -march=native -lpthread
+//
+// KPKP is the only table in which a double step can be answered en passant. It
+// needs every 3-man table and every one-against-one 4-man table for its
+// promotions, so it is slow to build and tested on its own.
+
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "chess/bitboard.h"
+#include "chess/board.h"
+#include "chess/movegen.h"
+#include "chess/zobrist.h"
+#include "engine/tablebase.h"
+#include "test_util.h"
+
+// plies is -1 when no table covers the position
+tb::Probe probe(std::string fen) {
+    Board board;
+    board.set_fen(fen);
+    tb::Probe result;
+    if (!tb::probe_dtm(board, result)) result.plies = -1;
+    return result;
+}
+
+// DTM byte for the side to move: probed where the tables allow it, searched
+// one ply deeper where an en-passant capture keeps them out
+int dtm_byte(Board& board, bool probe_it) {
+    tb::Probe p;
+    if (probe_it && tb::probe_dtm(board, p)) return p.wdl == tb::WDL_DRAW ? tb::DTM_DRAW : p.plies;
+    chess::MoveList moves;
+    MoveGen::init(board, moves, MoveGen::ALL, true);
+    if (moves.empty()) return board.checks ? 0 : tb::DTM_DRAW;
+    // The fastest win, then a draw, then the slowest loss
+    auto rank = [](int v) { return v == tb::DTM_DRAW ? 500 : (v & 1) ? 1000 - v : v; };
+    int best = -1;
+    for (const chess::Move& m : moves) {
+        board.make_move(m);
+        const int child = dtm_byte(board, true);
+        board.unmake_move(m);
+        const int v = child == tb::DTM_DRAW ? tb::DTM_DRAW : child + 1;
+        if (best < 0 || rank(v) > rank(best)) best = v;
+    }
+    return best;
+}
+
+int main() {
+    chess::init();
+    Zobrist::init_zobrist_keys();
+    bool ok = true;
+    std::string error;
+    const std::string dir = "tablebase_kpkp_test_dir";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+
+    bool generated = true;
+    const size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    for (const std::string& name : tb::all_tables(4)) {
+        if (name.size() == 4 && name[2] != 'K') continue; // two pieces on one side
+        tb::GenerateStats stats;
+        generated = generated && tb::generate(name, dir, threads, stats, error);
+    }
+    Board board;
+    std::string fen = "8/8/8/3k4/3p4/8/4P3/4K3 w - - 0 1";
+    board.set_fen(fen);
+    tb::Placement placement;
+    const tb::Table* table = tb::find(board, placement);
+    ok &= report("Generate KPKP", generated && table && table->name == "KPKP");
+
+    // After b5 white's only resource is axb6 en passant, which stalemates; the
+    // same position without the capture loses
+    ok &= report("En passant draws", probe("k7/1pK5/8/P7/8/8/8/8 b - - 0 1").wdl == tb::WDL_DRAW &&
+                                     probe("k7/2K5/8/Pp6/8/8/8/8 w - b6 0 1").plies == -1 &&
+                                     probe("k7/2K5/8/Pp6/8/8/8/8 w - - 0 1").wdl == tb::WDL_LOSS);
+
+    // Every position with a double step the opponent can take en passant agrees
+    // with a search of its moves
+    uint64_t checked = 0, wrong = 0;
+    for (uint64_t i = 0; table && i < table->size; ++i) {
+        const tb::Placement p = tb::placement_of(*table, i);
+        if (tb::index_of(*table, p) != i) continue;
+        const int rank[2] = {p.squares[2] >> 3, p.squares[3] >> 3};
+        const int files = std::abs((p.squares[2] & 7) - (p.squares[3] & 7));
+        // A pawn on its second rank, the enemy pawn next to its double-step square
+        const bool white_jumps = p.white_to_move && rank[0] == 1 && rank[1] == 3 && files == 1;
+        const bool black_jumps = !p.white_to_move && rank[1] == 6 && rank[0] == 4 && files == 1;
+        if (!white_jumps && !black_jumps) continue;
+
+        const chess::Piece pieces[4] = {chess::WK, chess::BK, chess::WP, chess::BP};
+        uint64_t seen = 0;
+        bool legal = true;
+        for (int k = 0; k < 4; ++k) {
+            legal &= !(seen >> p.squares[k] & 1);
+            seen |= uint64_t(1) << p.squares[k];
+        }
+        if (!legal) continue;
+        Board b;
+        b.clear();
+        for (int k = 0; k < 4; ++k) {
+            b.board_array[p.squares[k]] = pieces[k];
+            util::set_bit(b.bitboard[pieces[k]], p.squares[k]);
+        }
+        b.white_to_move = p.white_to_move;
+        b.finish_setup();
+        if (b.square_attacked(b.white_to_move ? b.black_king_sq : b.white_king_sq, b.white_to_move)) continue;
+        ++checked;
+        wrong += dtm_byte(b, false) != table->dtm[i];
+    }
+    std::cout << "    " << checked << " positions with a double step checked, " << wrong << " wrong" << std::endl;
+    ok &= report("Double steps searched", checked > 1000 && wrong == 0);
+
+    tb::unload();
+    std::filesystem::remove_all(dir);
+    return ok ? 0 : 1;
+}
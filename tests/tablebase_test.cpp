@@ -0,0 +1,117 @@
+// Compile using: g++ -std=c++17 -I../include -o tablebase_test.out tablebase_test.cpp ../src/chess/*.cpp ../src/chess/movegen/*.cpp ../src/engine/*.cpp ../src/engine/search/*.cpp ../src/utils/*.cpp -O3 -march=native -lpthread
+
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "chess/bitboard.h"
+#include "chess/board.h"
+#include "chess/zobrist.h"
+#include "engine/search.h"
+#include "engine/tablebase.h"
+#include "test_util.h"
+
+// plies is -1 when no table covers the position
+tb::Probe probe(std::string fen) {
+    Board board;
+    board.set_fen(fen);
+    tb::Probe result;
+    if (!tb::probe_dtm(board, result)) result.plies = -1;
+    return result;
+}
+
+bool is(const tb::Probe& p, tb::WDL wdl, int plies) { return p.wdl == wdl && p.plies == plies; }
+
+// The same position with the files mirrored (a <-> h)
+std::string mirror_files(const std::string& fen) {
+    std::istringstream in(fen);
+    std::string placement, rest, word;
+    in >> placement;
+    while (in >> word) rest += " " + word;
+    std::string out, rank;
+    std::istringstream rows(placement);
+    while (std::getline(rows, rank, '/')) {
+        out += (out.empty() ? "" : "/") + std::string(rank.rbegin(), rank.rend());
+    }
+    return out + rest;
+}
+
+int main() {
+    chess::init();
+    Zobrist::init_zobrist_keys();
+    bool ok = true;
+    std::string error;
+    const std::string dir = "tablebase_test_dir";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+
+    // Generation: the longest mates are the well-known ones
+    bool generated = true;
+    int longest[5] = {};
+    const std::vector<std::string> names = tb::all_tables(3);
+    for (size_t i = 0; i < names.size(); ++i) {
+        tb::GenerateStats stats;
+        generated &= tb::generate(names[i], dir, 2, stats, error);
+        longest[i] = stats.max_plies;
+        std::cout << "    " << names[i] << ": " << stats.positions << " positions, " << stats.wins << " won, longest mate "
+                  << stats.max_plies << " plies, " << stats.seconds << " s" << std::endl;
+    }
+    ok &= report("Generate 3-man", generated && names == std::vector<std::string>{"KQK", "KRK", "KBK", "KNK", "KPK"});
+    ok &= report("Longest mates", longest[0] == 19 && longest[1] == 31 && longest[2] == 0 && longest[3] == 0);
+
+    // Probes, with either colour holding the material
+    tb::unload();
+    ok &= report("Load", tb::load(dir, error) && tb::tables_loaded() == 5 && tb::max_pieces() == 3);
+    ok &= report("Mate in one", is(probe("7k/8/6K1/8/8/8/8/1Q6 w - - 0 1"), tb::WDL_WIN, 1));
+    ok &= report("Mated", is(probe("k7/1Q6/1K6/8/8/8/8/8 b - - 0 1"), tb::WDL_LOSS, 0) &&
+                          is(probe("K7/1q6/1k6/8/8/8/8/8 w - - 0 1"), tb::WDL_LOSS, 0));
+    ok &= report("KPK", probe("4k3/8/4K3/4P3/8/8/8/8 w - - 0 1").wdl == tb::WDL_WIN &&
+                        probe("4k3/8/4K3/4P3/8/8/8/8 b - - 0 1").wdl == tb::WDL_LOSS &&
+                        probe("8/8/8/8/4p3/4k3/8/4K3 w - - 0 1").wdl == tb::WDL_LOSS &&
+                        is(probe("7k/8/7K/7P/8/8/8/8 w - - 0 1"), tb::WDL_DRAW, 0));
+    ok &= report("Not covered", probe("4k3/8/8/8/8/8/8/4K2R w K - 0 1").plies == -1 &&
+                                probe("4k3/8/8/8/8/8/1P6/4K2R w - - 0 1").plies == -1 &&
+                                is(probe("8/8/3k4/8/8/3K4/8/8 w - - 0 1"), tb::WDL_DRAW, 0));
+
+    // Mirrored positions probe the same, and the WDL file agrees with the DTM file
+    bool mirrored = true;
+    for (const char* fen : {"7k/8/6K1/8/8/8/8/1Q6 w - - 0 1", "4k3/8/4K3/4P3/8/8/8/8 b - - 0 1", "8/2k5/8/8/3K4/8/5R2/8 w - - 0 1",
+                            "8/8/1k6/8/8/8/5P2/7K b - - 0 1", "8/8/8/3k4/8/8/1P6/3K4 w - - 0 1"}) {
+        const tb::Probe a = probe(fen), b = probe(mirror_files(fen));
+        mirrored &= a.plies >= 0 && a.wdl == b.wdl && a.plies == b.plies;
+    }
+    ok &= report("Mirrored positions", mirrored);
+
+    bool consistent = true;
+    for (const std::string name : {"KQK", "KPK"}) {
+        Board board;
+        std::string fen = name == "KQK" ? "7k/8/6K1/8/8/8/8/1Q6 w - - 0 1" : "4k3/8/4K3/4P3/8/8/8/8 w - - 0 1";
+        board.set_fen(fen);
+        tb::Placement p;
+        const tb::Table* table = tb::find(board, p);
+        for (uint64_t i = 0; table && i < table->size; ++i) {
+            const uint8_t dtm = table->dtm[i];
+            const int wdl = (table->wdl[i >> 2] >> (2 * (i & 3))) & 3;
+            consistent &= wdl == (dtm == tb::DTM_DRAW ? 0 : (dtm & 1) ? 2 : 1);
+        }
+        consistent &= table != nullptr;
+    }
+    ok &= report("WDL matches DTM", consistent);
+
+    // The search plays tablebase positions from the root, and scores captures into them
+    Search search(16);
+    Board board;
+    std::string fen = "7k/8/6K1/8/8/8/8/1Q6 w - - 0 1";
+    board.set_fen(fen);
+    chess::Move root_move = search.start_search(board, 10, 0, 0, 0, 0, 0);
+    ok &= report("Root probe", util::move_to_string(root_move) == "b1b8" && search.nodes_searched == 0);
+
+    fen = "8/8/8/8/8/7k/1p6/1Q2K3 w - - 0 1";
+    board.set_fen(fen);
+    chess::Move capture = search.start_search(board, 4, 0, 0, 0, 0, 0);
+    ok &= report("Search probes", util::move_to_string(capture) == "b1b2" && search.tb_hits() > 0);
+
+    tb::unload();
+    std::filesystem::remove_all(dir);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+
+// Prints "<name>: PASSED ✅" or "<name>: FAILED ❌" and returns ok, for ok &= report(...)
+inline bool report(const std::string& name, bool ok) {
+    std::cout << name << ": " << (ok ? "PASSED ✅" : "FAILED ❌") << std::endl;
+    return ok;
+}
@@ -0,0 +1,102 @@
+// Compile using: g++ -std=c++17 -I../include -o tuner_test.out tuner_test.cpp ../src/chess/*.cpp ../src/chess/movegen/*.cpp ../src/engine/*.cpp ../src/engine/search/*.cpp ../src/utils/*.cpp -O3 -march=native -lpthread
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "chess/board.h"
+#include "chess/zobrist.h"
+#include "engine/evaluate.h"
+#include "engine/tuner.h"
+#include "test_util.h"
+
+static const char* const DATASET[] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1 [0.5]",
+    "r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4 \"1/2-1/2\";",
+    "r4rk1/1pp2ppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10 | 1-0",
+    "6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1 1-0",
+    "6k1/5ppp/8/8/8/8/5PPP/3r2K1 b - - 0 1 [0.0]",
+    "8/8/4k3/8/2K5/8/8/8 w - - 0 1 [0.5]",
+    "rnbqkbnr/pppp1ppp/8/4p3/4P3/8/PPPP1PPP/RNBQKBNR w KQkq e6 0 2 [1.0]",
+    "r3k2r/ppp2ppp/8/8/8/8/PPP2PPP/R3K2R b Kq - 0 1 0-1",
+    "4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1 [0.5]",
+    "no result on this line",
+};
+
+double dataset_error(const std::string& path, size_t threads, bool qsearch, size_t& count) {
+    tuner::Options options;
+    options.dataset = path;
+    options.threads = threads;
+    options.qsearch = qsearch;
+    options.chunk_size = 3; // several chunks even for a small file
+    tuner::Tuner t(options);
+    std::string error;
+    if (!t.open(error)) return -1;
+    const double e = t.error(1.0);
+    count = t.positions();
+    return e;
+}
+
+int main() {
+    chess::init();
+    Zobrist::init_zobrist_keys();
+    bool ok = true;
+    std::string error;
+    const std::string text_path = "tuner_test.epd";
+    const std::string packed_path = "tuner_test.bin";
+    {
+        std::ofstream out(text_path);
+        for (const char* line : DATASET) out << line << '\n';
+    }
+
+    // Packing keeps everything the FEN says apart from the move number
+    bool round_trip = true;
+    for (const char* line : DATASET) {
+        double result = 0;
+        if (!tuner::parse_result(line, result)) continue;
+        Board board, unpacked;
+        std::string fen = tuner::fen_of_line(line);
+        board.set_fen(fen);
+        round_trip &= tuner::unpack(tuner::pack(board, result), unpacked) == result;
+        round_trip &= unpacked.to_fen() == board.to_fen() && unpacked.zobrist_key == board.zobrist_key;
+    }
+    ok &= report("Pack round trip", round_trip);
+
+    // Both formats stream the same positions, whatever the number of threads
+    size_t packed_count = 0, text_count = 0, threaded_count = 0;
+    const bool packed = tuner::pack_dataset(text_path, packed_path, packed_count, error);
+    const double text_error = dataset_error(text_path, 1, false, text_count);
+    const double packed_error = dataset_error(packed_path, 1, false, packed_count);
+    const double threaded_error = dataset_error(packed_path, 3, false, threaded_count);
+    std::cout << "    " << text_count << " positions, error " << text_error << std::endl;
+    ok &= report("Text and packed datasets", packed && text_count == 9 && packed_count == 9 &&
+                 std::abs(text_error - packed_error) < 1e-12);
+    ok &= report("Threaded error", threaded_count == 9 && std::abs(threaded_error - packed_error) < 1e-12);
+
+    size_t qsearch_count = 0;
+    const double qsearch_error = dataset_error(packed_path, 2, true, qsearch_count);
+    ok &= report("Qsearch error", qsearch_count == 9 && qsearch_error > 0 && qsearch_error < 1);
+
+    // Local search never makes the error worse, and leaves the tuned set active
+    tuner::Options options;
+    options.dataset = packed_path;
+    options.threads = 2;
+    tuner::Tuner t(options);
+    t.open(error);
+    eval::EvalData params = eval::default_eval_data;
+    eval::set_params(params);
+    const double k = 1.0;
+    const double before = t.error(k);
+    double best = before;
+    t.local_search(params, {"rook_on_open_file_bonus", "bishop_pair_bonus"}, k, best);
+    const double after = t.error(k);
+    std::cout << "    error " << before << " -> " << after << std::endl;
+    ok &= report("Local search", best <= before && std::abs(after - best) < 1e-12 &&
+                 eval::active->rook_on_open_file_bonus.mg == params.rook_on_open_file_bonus.mg);
+    eval::reset_params();
+
+    std::remove(text_path.c_str());
+    std::remove(packed_path.c_str());
+    return ok ? 0 : 1;
+}
@@ -1,4 +1,4 @@
-// Compile using: g++ -std=c++17 -I../include/chess -I../include -I../include/utils -o zobrist_test.out zobrist_test.cpp ../src/chess/*.cpp ../src/chess/movegen/*.cpp ../src/utils/threadpool.cpp ../src/engine/search.cpp ../src/engine/move_orderer.cpp ../src/engine/evaluate.cpp ../src/engine/search/*.cpp -O3 -march=native -flto -funroll-loops
+// Compile using: g++ -std=c++17 -I../include/chess -I../include -I../include/utils -o zobrist_test.out zobrist_test.cpp ../src/chess/*.cpp ../src/chess/movegen/*.cpp ../src/utils/threadpool.cpp ../src/engine/search.cpp ../src/engine/move_picker.cpp ../src/engine/evaluate.cpp ../src/engine/search/*.cpp -O3 -march=native -flto -funroll-loops
 
 #include <iostream>
 #include <vector>
@@ -12,8 +12,8 @@
 
 // Helper function to parse a UCI move string and find the corresponding move
 chess::Move parse_move(Board& b, const std::string& move_str) {
-    std::vector<chess::Move> moveList;
-    MoveGen::init(b, moveList, false);
+    chess::MoveList moveList;
+    MoveGen::init(b, moveList, MoveGen::ALL, true);
     for (const auto& move : moveList) {
         if (util::move_to_string(move) == move_str) {
             return move;
@@ -31,7 +31,8 @@ void test_polyglot_vectors() {
     // Map of FEN strings to their expected Polyglot hash
     std::map<std::string, uint64_t> test_cases = {
         {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 0x463b96181691fc9c},
-        {"rnbqkbnr/pppp1ppp/8/4p3/4P3/8/PPPP1PPP/RNBQKBNR w KQkq e6 0 2", 0x823c9b50fd114196},
+        {"rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1", 0x823c9b50fd114196},
+        {"rnbqkbnr/pppp1ppp/8/4p3/4P3/8/PPPP1PPP/RNBQKBNR w KQkq e6 0 2", 0x0844931a6ef4b9a0},
         {"rnbqkbnr/ppp1pppp/8/3p4/4P3/8/PPPP1PPP/RNBQKBNR w KQkq d6 0 2", 0x0756b94461c50fb0},
         {"rnbqkbnr/ppp1pppp/8/3pP3/8/8/PPPP1PPP/RNBQKBNR b KQkq - 0 2", 0x662fafb965db29d4},
         {"rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3", 0x22a48b5a8e47ff78},
@@ -146,10 +147,51 @@ void test_transposition(std::string fen_str) {
 }
 
 
+// Test 3: Walks the full move tree (perft style) and compares the incremental
+// key from make_move against a full recompute at every node, and checks that
+// unmake_move restores the parent key.
+uint64_t hash_perft(Board& board, int depth, uint64_t& mismatches) {
+    if (board.zobrist_key != Zobrist::calculate_zobrist_hash(board)) mismatches++;
+    if (board.zobrist_pawn_key != Zobrist::calculate_pawn_hash(board)) mismatches++;
+    if (depth == 0) return 1ULL;
+
+    chess::MoveList moveList;
+    MoveGen::init(board, moveList, MoveGen::ALL, true);
+
+    uint64_t nodes = 0;
+    const uint64_t parent_key = board.zobrist_key;
+    const uint64_t parent_pawn_key = board.zobrist_pawn_key;
+    for (const auto& move : moveList) {
+        board.make_move(move);
+        nodes += hash_perft(board, depth - 1, mismatches);
+        board.unmake_move(move);
+        if (board.zobrist_key != parent_key || board.zobrist_pawn_key != parent_pawn_key) mismatches++;
+    }
+    return nodes;
+}
+
+bool test_incremental_perft(std::string fen, int depth) {
+    std::cout << "--- Incremental Hash Perft ---" << std::endl;
+    std::cout << "FEN: " << fen << ", depth " << depth << std::endl;
+
+    Board board;
+    board.set_fen(fen);
+
+    uint64_t mismatches = 0;
+    uint64_t nodes = hash_perft(board, depth, mismatches);
+
+    std::cout << "Nodes: " << nodes << ", Mismatches: " << mismatches << std::endl;
+    std::cout << "Result: " << (mismatches == 0 ? "PASSED ✅" : "FAILED ❌") << std::endl;
+    std::cout << "------------------------" << std::endl << std::endl;
+    return mismatches == 0;
+}
+
+
 int main() {
     // --- THIS IS THE MOST IMPORTANT FIX ---
     // Initialize the Zobrist keys *before* doing anything else.
     Zobrist::init_zobrist_keys(); 
+    chess::init(); // Attack tables are needed for move generation
     // ------------------------------------
 
     std::cout << "==========================================\n";
@@ -175,7 +217,16 @@ int main() {
     // Run transposition test
     test_transposition(start_fen);
 
+    // Incremental vs full hash (and pawn hash) over whole trees: castling, ep (capturable and
+    // not), promotions and captures of rooks on their home squares.
+    bool hashes_match = true;
+    hashes_match &= test_incremental_perft(start_fen, 4);
+    hashes_match &= test_incremental_perft("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 3);
+    hashes_match &= test_incremental_perft("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 5);
+    hashes_match &= test_incremental_perft("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 3);
+    hashes_match &= test_incremental_perft("rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3", 3);
+
     std::cout << "Test run finished.\n";
     
-    return 0;
+    return hashes_match ? 0 : 1;
 }
\ No newline at end of file
@@ -0,0 +1,105 @@
+// Evaluation trace and term profile over a file of positions.
+//
+//   evaltrace <positions.epd> [--params file] [--table] [--profile] [--runs N]
+//
+// Reads one position per line, EPD or FEN (only the first four fields are
+// read). Prints a CSV line per position with each term's tapered white - black
+// contribution and the evaluation for the side to move, then the mean absolute
+// contribution of every term. --table prints the full mg/eg table for each
+// position instead. --profile times every term over the positions, runs times.
+
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+#include "chess/board.h"
+#include "chess/zobrist.h"
+#include "engine/evaluate.h"
+#include "engine/tuner.h"
+
+static int usage() {
+    std::cerr << "usage: evaltrace <positions.epd> [--params file] [--table] [--profile] [--runs N]" << std::endl;
+    return 1;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) return usage();
+    chess::init();
+    Zobrist::init_zobrist_keys();
+
+    std::string params_path;
+    bool table = false, profile = false;
+    int runs = 100;
+    for (int i = 2; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--table") table = true;
+        else if (arg == "--profile") profile = true;
+        else if (arg == "--params" && has_value) params_path = argv[++i];
+        else if (arg == "--runs" && has_value) runs = std::max(1, std::stoi(argv[++i]));
+        else return usage();
+    }
+
+    std::string error;
+    eval::EvalData params = eval::default_eval_data;
+    if (!params_path.empty() && !eval::load_params(params_path, params, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    eval::set_params(params);
+
+    std::ifstream in(argv[1]);
+    if (!in) {
+        std::cerr << "cannot open " << argv[1] << std::endl;
+        return 1;
+    }
+    std::vector<Board> positions;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::string fen = tuner::fen_of_line(line);
+        positions.emplace_back();
+        positions.back().set_fen(fen);
+    }
+    if (positions.empty()) {
+        std::cerr << "no positions in " << argv[1] << std::endl;
+        return 1;
+    }
+
+    if (profile) {
+        std::cout << positions.size() << " positions x " << runs << " runs\n"
+                  << std::setw(14) << "term" << std::setw(12) << "ns/pos" << std::setw(14) << "cycles/pos" << "\n";
+        for (const eval::TermCost& cost : eval::profile_terms(positions, runs)) {
+            std::cout << std::setw(14) << cost.name << std::fixed << std::setprecision(1)
+                      << std::setw(12) << cost.ns << std::setw(14) << cost.cycles << "\n";
+        }
+        return 0;
+    }
+
+    if (!table) {
+        std::cout << "fen";
+        for (const char* name : eval::TERM_NAMES) std::cout << "," << name;
+        std::cout << ",evaluation\n";
+    }
+    double mean_abs[eval::TERM_NB] = {};
+    for (Board& board : positions) {
+        eval::Trace trace;
+        eval::trace(board, trace);
+        if (table) std::cout << board.to_fen() << "\n" << eval::format_trace(trace) << "\n";
+        else std::cout << board.to_fen();
+        for (int term = 0; term < eval::TERM_NB; ++term) {
+            const int value = trace.tapered(trace.terms[term][chess::WHITE] - trace.terms[term][chess::BLACK]);
+            mean_abs[term] += std::abs(value) / double(positions.size());
+            if (!table) std::cout << "," << value;
+        }
+        if (!table) std::cout << "," << trace.score << "\n";
+    }
+
+    std::cout << "# mean absolute contribution over " << positions.size() << " positions\n";
+    for (int term = 0; term < eval::TERM_NB; ++term) {
+        std::cout << "# " << std::setw(14) << eval::TERM_NAMES[term] << std::fixed << std::setprecision(1)
+                  << std::setw(10) << mean_abs[term] << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,73 @@
+// Endgame tablebase generator.
+//
+//   tbgen <dir> [--pieces 3|4] [--threads N] [--tables KQKR,KRKP,...]
+//
+// Generates every 3- and 4-man table (or only 3-man ones, or the listed
+// tables) into dir. Tables already in dir are loaded rather than generated
+// again, so an interrupted run picks up where it stopped. Point the
+// TablebasePath UCI option at dir to use them.
+
+#include <algorithm>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include "chess/bitboard.h"
+#include "chess/zobrist.h"
+#include "engine/tablebase.h"
+
+static int usage() {
+    std::cerr << "usage: tbgen <dir> [--pieces 3|4] [--threads N] [--tables KQKR,...]" << std::endl;
+    return 1;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) return usage();
+    chess::init();
+    Zobrist::init_zobrist_keys();
+
+    const std::string dir = argv[1];
+    int pieces = tb::MAX_PIECES;
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::string> wanted;
+    for (int i = 2; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc) return usage();
+        if (arg == "--pieces") pieces = std::stoi(argv[++i]);
+        else if (arg == "--threads") threads = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--tables") {
+            std::istringstream list(argv[++i]);
+            std::string name;
+            while (std::getline(list, name, ',')) wanted.push_back(name);
+        } else return usage();
+    }
+
+    std::string error;
+    std::filesystem::create_directories(dir);
+    tb::load(dir, error);
+
+    double total_seconds = 0;
+    for (const std::string& name : tb::all_tables(pieces)) {
+        if (!wanted.empty() && std::find(wanted.begin(), wanted.end(), name) == wanted.end()) continue;
+        if (tb::load_table(dir, name, error)) {
+            std::cout << name << ": loaded" << std::endl;
+            continue;
+        }
+        tb::GenerateStats stats;
+        if (!tb::generate(name, dir, threads, stats, error)) {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+        total_seconds += stats.seconds;
+        const auto dtm_bytes = std::filesystem::file_size(std::filesystem::path(dir) / (name + ".dtm"));
+        const auto wdl_bytes = std::filesystem::file_size(std::filesystem::path(dir) / (name + ".wdl"));
+        std::cout << std::left << std::setw(5) << name << std::right << std::fixed << std::setprecision(2)
+                  << " " << std::setw(8) << stats.seconds << " s  "
+                  << stats.positions << " positions: " << stats.wins << " won, " << stats.draws << " drawn, "
+                  << stats.losses << " lost, longest mate " << stats.max_plies << " plies  "
+                  << "dtm " << dtm_bytes / 1024 << " KiB, wdl " << wdl_bytes / 1024 << " KiB" << std::endl;
+    }
+    std::cout << "generated in " << std::fixed << std::setprecision(1) << total_seconds << " s with " << threads << " threads" << std::endl;
+    return 0;
+}
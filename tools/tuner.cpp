@@ -0,0 +1,98 @@
+// Texel tuner for the classic evaluation.
+//
+//   tuner <dataset> [--out tuned.txt] [--params start.txt] [--threads N]
+//         [--qsearch] [--k K] [--iterations N] [--fields name,name,...]
+//   tuner --pack <dataset.epd> <dataset.bin>
+//
+// Datasets are text (FEN followed by the result, see engine/tuner.h) or packed
+// with --pack, which is smaller and faster to stream. The tuned parameters are
+// written after every iteration in the format of the EvalParams UCI option.
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include "chess/board.h"
+#include "chess/zobrist.h"
+#include "engine/tuner.h"
+
+static int usage() {
+    std::cerr << "usage: tuner <dataset> [--out file] [--params file] [--threads N] [--qsearch] [--k K]"
+                 " [--iterations N] [--fields a,b,...]\n"
+                 "       tuner --pack <dataset.epd> <dataset.bin>" << std::endl;
+    return 1;
+}
+
+int main(int argc, char* argv[]) {
+    chess::init();
+    Zobrist::init_zobrist_keys();
+    std::string error;
+
+    if (argc == 4 && std::string(argv[1]) == "--pack") {
+        size_t count = 0;
+        if (!tuner::pack_dataset(argv[2], argv[3], count, error)) {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+        std::cout << "packed " << count << " positions into " << argv[3] << std::endl;
+        return 0;
+    }
+    if (argc < 2) return usage();
+
+    tuner::Options options;
+    options.dataset = argv[1];
+    options.threads = std::max(1u, std::thread::hardware_concurrency());
+    std::string out_path = "tuned.txt";
+    std::string params_path;
+    std::vector<std::string> fields;
+    double k = 0; // fitted when not given
+    int iterations = 1000;
+
+    for (int i = 2; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--qsearch") options.qsearch = true;
+        else if (arg == "--out" && has_value) out_path = argv[++i];
+        else if (arg == "--params" && has_value) params_path = argv[++i];
+        else if (arg == "--threads" && has_value) options.threads = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--k" && has_value) k = std::stod(argv[++i]);
+        else if (arg == "--iterations" && has_value) iterations = std::stoi(argv[++i]);
+        else if (arg == "--fields" && has_value) {
+            std::istringstream list(argv[++i]);
+            std::string name;
+            while (std::getline(list, name, ',')) fields.push_back(name);
+        } else return usage();
+    }
+
+    eval::EvalData params = eval::default_eval_data;
+    if (!params_path.empty() && !eval::load_params(params_path, params, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    eval::set_params(params);
+
+    tuner::Tuner tuner(options);
+    if (!tuner.open(error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    if (k == 0) k = tuner.fit_k();
+    double best_error = tuner.error(k);
+    auto pass_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    std::cout << tuner.positions() << " positions, " << options.threads << " threads, K = " << k
+              << ", error " << best_error << " (" << pass_ms << " ms)" << std::endl;
+
+    for (int iteration = 1; iteration <= iterations; ++iteration) {
+        const size_t changed = tuner.local_search(params, fields, k, best_error);
+        if (!eval::save_params(out_path, params, error)) {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+        std::cout << "iteration " << iteration << ": error " << best_error << ", " << changed
+                  << " values changed, saved " << out_path << std::endl;
+        if (changed == 0) break;
+    }
+    return 0;
+}